@@ -3,7 +3,11 @@
 
 #include "transport.h"
 #include "ble_config.h"
+#include "fragment.h"
 
+#include <functional>
+#include <list>
+#include <optional>
 #include <vector>
 
 namespace net
@@ -21,6 +25,49 @@ namespace net
     public:
         static constexpr auto TAG = "BLE";
 
+        /// @brief MTU по умолчанию до обмена ESP_GATTS_MTU_EVT
+        static constexpr uint16_t DEFAULT_MTU = 23;
+
+        /// @brief Размер заголовка ATT уведомления/записи
+        static constexpr uint16_t ATT_HEADER_SIZE = 3;
+
+        /// @brief Количество уведомлений соединения, переданных стеку без подтверждения (ESP_GATTS_CONF_EVT)
+        static constexpr uint8_t NOTIFY_CREDITS = 8;
+
+        /// @brief Время, после которого кредиты восстанавливаются без подтверждений стека (мкс)
+        static constexpr int64_t CREDIT_TIMEOUT_US = 200 * 1000;
+
+        /// @brief Размер очереди отправки каждого соединения
+        static constexpr size_t PEER_QUEUE_SIZE = 8;
+
+        /// @brief Пакетов во всех очередях соединений (широковещательный учитывается в каждой очереди);
+        ///        ограничивает долю пула, которую могут занять медленные соединения
+        static constexpr size_t PEER_QUEUE_BUDGET = PacketPool::CAPACITY / 2;
+
+        /// @brief Задержка повторной попытки после отказа стека принять уведомление (мкс)
+        static constexpr int64_t PEER_RETRY_US = 10 * 1000;
+
+        /// @brief Время ожидания события стека на шаге настройки соединения (мкс)
+        static constexpr int64_t LINK_STEP_TIMEOUT_US = 2000 * 1000;
+
+        /**
+         * @brief Параметры канала соединения
+         */
+        struct LinkInfo
+        {
+            uint16_t mtu = DEFAULT_MTU;                     ///< Согласованный ATT MTU
+            uint16_t txOctets = 27;                         ///< Длина PDU канального уровня на передачу (байт)
+            esp_ble_gap_phy_t txPhy = ESP_BLE_GAP_PHY_1M;   ///< PHY передачи
+            esp_ble_gap_phy_t rxPhy = ESP_BLE_GAP_PHY_1M;   ///< PHY приёма
+            uint16_t interval = 0;                          ///< Интервал соединения (единицы 1.25 мс)
+            uint16_t latency = 0;                           ///< Задержка ведомого (событий)
+            uint16_t timeout = 0;                           ///< Таймаут контроля соединения (единицы 10 мс)
+            bool ready = false;                             ///< Настройка соединения завершена
+        };
+
+        /// @brief Callback изменения параметров канала соединения
+        using LinkFunction = std::function<void(uint16_t connId, const LinkInfo& info)>;
+
         /**
          * @brief Конструктор BLE-контроллера
          * @param deviceName Имя BLE устройства
@@ -30,8 +77,11 @@ namespace net
          * - Режим энергосбережения
          * - Поддерживаемую версию BLE (4.2 или 5.0)
          * - Параметры рекламы и соединений
+         * @param transportConfig Параметры рабочего потока и очередей (без ограничения скорости, если pacing не задан)
          */
-        explicit BLE(std::string deviceName, BleConfig::Preset preset = BleConfig::Preset::BLE4_DEFAULT);
+        explicit BLE(std::string deviceName,
+                     BleConfig::Preset preset = BleConfig::Preset::BLE4_DEFAULT,
+                     const TransportConfig& transportConfig = {});
         ~BLE() override;
 
         // Запрет копирования и присваивания
@@ -52,11 +102,33 @@ namespace net
         [[nodiscard]] esp_err_t initialize();
 
         /**
-         * @brief Получить текущий MTU/размер буфера
-         * @return size_t Максимальный размер передаваемых данных
+         * @brief Получить максимальный размер пакета
+         * @return size_t MAX_MTU при включённой фрагментации,
+         *         иначе полезная нагрузка наименьшего MTU среди соединений
          */
         [[nodiscard]] size_t getMtuSize() const noexcept override;
 
+        /**
+         * @brief Получить согласованный ATT MTU соединения
+         * @param connId Идентификатор соединения
+         * @return uint16_t MTU соединения или 0, если соединение не найдено
+         */
+        [[nodiscard]] uint16_t getConnectionMtu(uint16_t connId) const noexcept;
+
+        /**
+         * @brief Получить параметры канала соединения
+         * @param connId Идентификатор соединения
+         * @return std::optional<LinkInfo> Параметры или std::nullopt, если соединение не найдено
+         */
+        [[nodiscard]] std::optional<LinkInfo> getLinkInfo(uint16_t connId) const;
+
+        /**
+         * @brief Установить callback параметров канала
+         * @param callback Вызывается по завершении настройки соединения и при последующих изменениях
+         *                 MTU, PHY, длины PDU или интервала (из контекста стека BLE)
+         */
+        void setLinkCallback(LinkFunction callback);
+
         /**
          * @brief Быстрый старт BLE с настройками по умолчанию
          * @param callback Callback для обработки входящих данных
@@ -130,13 +202,43 @@ namespace net
          */
         [[nodiscard]] esp_err_t updateConfig(const BleConfig& newConfig);
 
+        /**
+         * @brief Включить/выключить автоматическое управление скоростью
+         * @param enable true - общая очередь транспорта работает без ограничения,
+         *               скорость определяется управлением потоком каждого соединения
+         * @note Управление потоком соединений (кредиты и события перегрузки стека) действует всегда.
+         *       При выключении общая очередь возвращается к ограничению по умолчанию,
+         *       после чего его можно задать через setPacing()
+         */
+        void setAutoPacing(bool enable);
+
     protected:
         /**
-         * @brief Отправить пакет данных
-         * @param packet Ссылка на пакет для отправки
-         * @return esp_err_t Код ошибки ESP-IDF
+         * @brief Поставить пакет в очереди соединений
+         * @details Внутри очереди соединения пакеты упорядочены по классу приоритета.
+         *          Широковещательный пакет, не принятый частью соединений, теряется только для них
+         *          (DropReason::PEER_OVERFLOW на каждое соединение)
+         * @param packet Дескриптор пакета для отправки (широковещательный пакет разделяется всеми очередями)
+         * @param priority Класс приоритета пакета
+         * @return esp_err_t ESP_OK если пакет принят хотя бы одним соединением,
+         *         ESP_ERR_NOT_FOUND если соединение не найдено,
+         *         ESP_ERR_NOT_FINISHED если очереди всех адресатов заполнены или исчерпан PEER_QUEUE_BUDGET
+         */
+        [[nodiscard]] esp_err_t sendImpl(const PacketRef& packet, Priority priority) override;
+
+        /**
+         * @brief Передача из очередей соединений по алгоритму deficit round-robin
+         * @return int64_t Задержка до следующей попытки (мкс) или -1, если очереди пусты
          */
-        [[nodiscard]] esp_err_t sendImpl(Packet& packet) override;
+        [[nodiscard]] int64_t processTransmit() override;
+
+        /**
+         * @brief Передать принятые пакеты из очереди приёма в callback данных
+         * @details Callback вызываются рабочим потоком, поэтому медленная обработка не задерживает
+         *          стек Bluetooth и ответ на запись. За вызов обрабатывается не больше пакетов,
+         *          чем было в очереди, чтобы непрерывный приём не останавливал отправку.
+         */
+        void processReceivedData(QueueSetMemberHandle_t source) override;
 
     private:
         /**
@@ -154,9 +256,20 @@ namespace net
 
         /**
          * @brief Обработка события записи в характеристику
+         * @details Собранный пакет ставится в очередь приёма, запись подтверждается сразу;
+         *          при заполненной очереди или исчерпанном пуле пакет отбрасывается (DropReason::RX_OVERFLOW)
          */
         void handleWriteEvent(uint16_t connId, const esp_ble_gatts_cb_param_t* param);
 
+        /**
+         * @brief Добавить принятый фрагмент к пакету соединения
+         * @param connId Идентификатор соединения
+         * @param data Фрагмент вместе с заголовком
+         * @param[out] packet Собранный пакет
+         * @return true - пакет собран полностью
+         */
+        [[nodiscard]] bool reassemble(uint16_t connId, std::span<const uint8_t> data, Packet& packet);
+
         /**
          * @brief Запуск legacy рекламы (BLE 4.x)
          */
@@ -169,24 +282,146 @@ namespace net
 
         /**
          * @brief Внутренний метод отправки данных конкретному устройству
+         * @param connId Идентификатор соединения
+         * @param data Данные одного уведомления (не больше MTU соединения без заголовка ATT)
+         */
+        [[nodiscard]] esp_err_t sendToDevice(uint16_t connId, std::span<uint8_t> data) const noexcept;
+
+        /**
+         * @brief Шаг настройки соединения
+         * @details Шаги выполняются последовательно для одного соединения за раз:
+         *          событие завершения DLE не содержит адреса устройства
          */
-        [[nodiscard]] esp_err_t sendToDevice(uint16_t connId, std::array<uint8_t, MAX_MTU>& buffer,
-                                             size_t size) const noexcept;
+        enum class LinkStage : uint8_t
+        {
+            PENDING,     ///< Ожидает очереди
+            DATA_LENGTH, ///< Запрос Data Length Extension
+            PHY,         ///< Запрос предпочтительного PHY
+            CONN_PARAMS, ///< Запрос параметров соединения
+            READY        ///< Настройка завершена
+        };
+
+        /**
+         * @brief Пакет очереди отправки соединения
+         */
+        struct PeerPacket
+        {
+            PacketRef packet;                          ///< Пакет
+            Priority priority = Priority::INTERACTIVE; ///< Класс приоритета
+        };
 
+        /**
+         * @brief Состояние подключенного устройства
+         */
         struct DeviceConnection
         {
-            uint16_t connId;
-            esp_bd_addr_t address;
+            uint16_t connId = 0;     ///< Идентификатор соединения
+            esp_bd_addr_t address{}; ///< MAC-адрес устройства
+            LinkInfo link;           ///< Параметры канала
+
+            LinkStage stage = LinkStage::PENDING; ///< Текущий шаг настройки
+            int64_t stageTime = 0;                ///< Время начала шага (мкс)
+
+            std::array<PeerPacket, PEER_QUEUE_SIZE> txQueue{}; ///< Кольцевая очередь отправки
+            size_t txHead = 0;                                 ///< Индекс первого пакета
+            size_t txCount = 0;                                ///< Количество пакетов в очереди
+            size_t deficit = 0;                                ///< Накопленный кредит DRR (байт)
+            size_t txOffset = 0;                               ///< Передано байт первого пакета
+            uint8_t txFragment = 0;                            ///< Номер следующего фрагмента первого пакета
+
+            uint8_t credits = NOTIFY_CREDITS; ///< Доступные кредиты на уведомления
+            bool congested = false;           ///< Стек сообщил о перегрузке соединения
+            int64_t creditTime = 0;           ///< Время последней выдачи/возврата кредита (мкс)
+
+            Reassembler rx; ///< Сборка принятых фрагментов
+
+            /**
+             * @brief Полезная нагрузка одного уведомления
+             */
+            [[nodiscard]] size_t payloadSize() const noexcept { return link.mtu - ATT_HEADER_SIZE; }
+
+            /**
+             * @brief Ожидается событие стека на шаге настройки
+             */
+            [[nodiscard]] bool isSettingUp() const noexcept
+            {
+                return stage != LinkStage::PENDING && stage != LinkStage::READY;
+            }
+
+            /**
+             * @brief Добавить пакет в очередь соединения
+             * @details Пакет встаёт за последним пакетом своего или более высокого класса;
+             *          частично переданный первый пакет не вытесняется
+             * @return false если очередь заполнена
+             */
+            bool push(const PacketRef& packet, Priority priority) noexcept;
+
+            /**
+             * @brief Удалить первый пакет из очереди
+             */
+            void pop() noexcept;
+
+            /**
+             * @brief Получить первый пакет очереди
+             */
+            [[nodiscard]] const PacketRef& front() const noexcept { return txQueue[txHead].packet; }
         };
 
-        BleConfig mConfig;                                ///< Текущая конфигурация BLE
-        std::vector<DeviceConnection> mActiveConnections; ///< Список активных подключений
+        /**
+         * @brief Найти соединение по идентификатору
+         * @return DeviceConnection* Соединение или nullptr
+         */
+        [[nodiscard]] DeviceConnection* findConnection(uint16_t connId) noexcept;
+
+        /**
+         * @brief Количество пакетов во всех очередях соединений
+         */
+        [[nodiscard]] size_t peerQueued() const noexcept;
+
+        /**
+         * @brief Передать пакеты одного соединения в пределах кредита DRR
+         * @details Квант раунда - полезная нагрузка одного уведомления соединения;
+         *          пакет больше MTU передаётся фрагментами в нескольких раундах
+         * @param conn Соединение
+         * @param now Текущее время (мкс)
+         * @return int64_t Задержка до следующей попытки (мкс), 0 - следующий раунд,
+         *         -1 - очередь пуста или соединение ждёт события стека
+         */
+        [[nodiscard]] int64_t transmitPeer(DeviceConnection& conn, int64_t now);
+
+        /**
+         * @brief Начать настройку следующего ожидающего соединения, если никакое не настраивается
+         */
+        void startLinkSetup();
+
+        /**
+         * @brief Перейти к следующему шагу настройки соединения
+         * @details Шаги, отключённые в конфигурации или не принятые стеком, пропускаются
+         */
+        void advanceLinkSetup(DeviceConnection& conn);
+
+        /**
+         * @brief Сообщить параметры канала (лог и callback)
+         */
+        void reportLink(const DeviceConnection& conn) const;
+
+        /**
+         * @brief Проверить таймаут шага настройки соединений
+         * @return int64_t Время до таймаута текущего шага (мкс) или -1, если настройка не идёт
+         */
+        [[nodiscard]] int64_t checkLinkSetup(int64_t now);
+
+        BleConfig mConfig;                              ///< Текущая конфигурация BLE
+        std::list<DeviceConnection> mActiveConnections; ///< Список активных подключений
 
         std::string mDeviceName;                   ///< Имя BLE-устройства для рекламы и подключения
         esp_gatt_if_t mGattsIf = ESP_GATT_IF_NONE; ///< Интерфейс GATT
         uint16_t mServiceHandle = 0;               ///< Хэндл сервиса
         uint16_t mCharHandle = 0;                  ///< Хэндл характеристики
-        uint16_t mMtu = 23;                        ///< Текущий размер MTU
+        std::array<uint8_t, MAX_MTU> mTxFrame{};   ///< Буфер формирования фрагмента
+        LinkFunction mLinkCallback;                ///< Callback параметров канала
+        bool mAutoPacing = true;                   ///< Автоматическое управление скоростью
+        HandleQueue mRxQueue;                      ///< Принятые пакеты, ожидающие рабочего потока
     };
 } // namespace net
 
@@ -177,6 +177,40 @@ namespace net
              * @brief Предпочитаемые PHY для приема
              */
             esp_ble_gap_phy_mask_t rxPhy = ESP_BLE_GAP_PHY_2M | ESP_BLE_GAP_PHY_1M;
+
+            /**
+             * @brief Локальный ATT MTU (23-517)
+             * @details Устанавливается через esp_ble_gatt_set_local_mtu; обмен MTU инициирует клиент,
+             *          согласованное значение - минимум из MTU сторон
+             */
+            uint16_t mtu = 247;
+
+            /**
+             * @brief Запрашиваемая длина PDU канального уровня (Data Length Extension, 27-251 байт)
+             * @note 0 - не запрашивать
+             */
+            uint16_t dataLength = 251;
+
+            /**
+             * @brief Минимальный интервал соединения (единицы 1.25 мс)
+             * @note 0 - не запрашивать обновление параметров соединения
+             */
+            uint16_t minInterval = 0;
+
+            /**
+             * @brief Максимальный интервал соединения (единицы 1.25 мс)
+             */
+            uint16_t maxInterval = 0;
+
+            /**
+             * @brief Задержка ведомого (количество пропускаемых событий соединения)
+             */
+            uint16_t latency = 0;
+
+            /**
+             * @brief Таймаут контроля соединения (единицы 10 мс)
+             */
+            uint16_t timeout = 400;
         } connection;
 
         /**
@@ -239,6 +273,17 @@ namespace net
             esp_gatt_perm_t charPermissions =
                 ESP_GATT_PERM_READ |
                 ESP_GATT_PERM_WRITE;
+
+            /**
+             * @brief Фрагментация пакетов по MTU соединения
+             * @details true - уведомления и записи передаются фрагментами с заголовком (см. fragment.h),
+             *          пакет любого размера до MAX_MTU доставляется при любом MTU соединения.
+             *          false - пакет передаётся одним уведомлением без заголовка и должен
+             *          помещаться в MTU соединения
+             * @note Меняет формат данных характеристики, поэтому включается явно, когда клиент
+             *       поддерживает заголовок фрагмента
+             */
+            bool fragmentation = false;
         } gatt;
 
     private:
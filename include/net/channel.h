@@ -0,0 +1,103 @@
+#ifndef NET_CHANNEL_H
+#define NET_CHANNEL_H
+
+#include "net/packet.h"
+#include "net/scheduler.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace net
+{
+    /**
+     * @file channel.h
+     * @brief Логические каналы поверх одного транспорта
+     * @details При включённых каналах первый байт данных пакета - номер канала. Заголовок
+     *          добавляется до сжатия и объединения и снимается после них, поэтому каналы
+     *          работают с любыми режимами транспорта.
+     */
+
+    /// @brief Количество логических каналов
+    constexpr size_t MAX_CHANNELS = 8;
+
+    /// @brief Размер заголовка канала (байт)
+    constexpr size_t CHANNEL_HEADER_SIZE = 1;
+
+    /**
+     * @brief Снимок статистики канала
+     */
+    struct ChannelStats
+    {
+        uint32_t packetsQueued = 0;   ///< Пакетов поставлено в очередь отправки
+        uint32_t bytesQueued = 0;     ///< Байт поставлено в очередь отправки (без заголовка)
+        uint32_t rejected = 0;        ///< Пакетов не принято очередью отправки
+        uint32_t packetsReceived = 0; ///< Пакетов передано в callback канала
+        uint32_t bytesReceived = 0;   ///< Байт передано в callback канала (без заголовка)
+    };
+
+    /**
+     * @brief Параметры и счётчики логических каналов
+     * @details Счётчики и классы приоритета обновляются атомарными операциями без упорядочивания,
+     *          поэтому доступны из любых задач без блокировок
+     */
+    class ChannelTable
+    {
+    public:
+        /**
+         * @brief Установить класс приоритета канала
+         */
+        void setPriority(uint8_t channel, Priority priority) noexcept;
+
+        /**
+         * @brief Получить класс приоритета канала (по умолчанию INTERACTIVE)
+         */
+        [[nodiscard]] Priority priority(uint8_t channel) const noexcept;
+
+        /**
+         * @brief Учесть пакет, поставленный в очередь отправки
+         */
+        void onQueued(uint8_t channel, size_t bytes) noexcept;
+
+        /**
+         * @brief Учесть пакет, не принятый очередью отправки
+         */
+        void onRejected(uint8_t channel) noexcept;
+
+        /**
+         * @brief Учесть принятый пакет
+         */
+        void onReceived(uint8_t channel, size_t bytes) noexcept;
+
+        /**
+         * @brief Получить снимок статистики канала
+         */
+        [[nodiscard]] ChannelStats stats(uint8_t channel) const noexcept;
+
+        /**
+         * @brief Обнулить статистику всех каналов
+         */
+        void resetStats() noexcept;
+
+    private:
+        using Counter = std::atomic<uint32_t>;
+
+        /**
+         * @brief Состояние канала
+         */
+        struct Channel
+        {
+            std::atomic<Priority> priority = Priority::INTERACTIVE; ///< Класс приоритета
+            Counter packetsQueued{};                                ///< Пакетов поставлено в очередь
+            Counter bytesQueued{};                                  ///< Байт поставлено в очередь
+            Counter rejected{};                                     ///< Пакетов не принято очередью
+            Counter packetsReceived{};                              ///< Пакетов принято
+            Counter bytesReceived{};                                ///< Байт принято
+        };
+
+        std::array<Channel, MAX_CHANNELS> mChannels; ///< Каналы
+    };
+} // namespace net
+
+#endif // NET_CHANNEL_H
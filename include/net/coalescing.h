@@ -0,0 +1,100 @@
+#ifndef NET_COALESCING_H
+#define NET_COALESCING_H
+
+#include "net/packet.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace net
+{
+    /**
+     * @file coalescing.h
+     * @brief Объединение коротких пакетов одного адресата в общий пакет (в духе алгоритма Нейгла)
+     * @details Объединённый пакет - последовательность записей «длина + данные»:
+     * - 0LLLLLLL - длина 1-127 байт
+     * - 1LLLLLLL LLLLLLLL - длина 128-32767 байт (старший байт первым)
+     *
+     * Объединяются только пакеты с одинаковым Packet::id и классом приоритета, порядок сохраняется.
+     */
+
+    /**
+     * @brief Политика объединения пакетов при отправке
+     */
+    struct CoalescingPolicy
+    {
+        static constexpr uint32_t DEFAULT_FLUSH_DELAY_US = 5 * 1000; ///< Ожидание попутных пакетов по умолчанию (5 мс)
+
+        bool enabled = false;       ///< Объединение включено
+        uint32_t flushDelayUs = 0;  ///< Сколько первый пакет ждёт попутные пакеты (мкс, 0 - только уже стоящие в очереди)
+
+        /**
+         * @brief Отправка без объединения
+         */
+        [[nodiscard]] static constexpr CoalescingPolicy disabled() noexcept
+        {
+            return {};
+        }
+
+        /**
+         * @brief Объединение пакетов
+         * @param flushDelayUs Максимальная задержка первого пакета в ожидании попутных (мкс)
+         */
+        [[nodiscard]] static constexpr CoalescingPolicy batched(
+            const uint32_t flushDelayUs = DEFAULT_FLUSH_DELAY_US) noexcept
+        {
+            return {.enabled = true, .flushDelayUs = flushDelayUs};
+        }
+    };
+
+    /**
+     * @brief Размер записи пакета в объединённом пакете
+     * @param size Размер данных пакета
+     * @return size_t Размер заголовка и данных
+     */
+    [[nodiscard]] constexpr size_t batchRecordSize(const size_t size) noexcept
+    {
+        return size + (size < 0x80 ? 1 : 2);
+    }
+
+    /**
+     * @brief Добавить пакет в объединённый пакет
+     * @param batch Объединённый пакет (Packet::size - занятый объём)
+     * @param packet Добавляемый пакет
+     * @param limit Максимальный размер объединённого пакета (не больше MAX_MTU)
+     * @return bool false - запись не помещается в limit, batch не изменён
+     */
+    [[nodiscard]] bool appendRecord(Packet& batch, const Packet& packet, size_t limit) noexcept;
+
+    /**
+     * @brief Последовательное чтение пакетов из объединённого пакета
+     */
+    class BatchReader
+    {
+    public:
+        /**
+         * @brief Конструктор
+         * @param batch Объединённый пакет; должен существовать, пока используется читатель
+         */
+        explicit BatchReader(const Packet& batch) noexcept : mBatch(batch) {}
+
+        /**
+         * @brief Прочитать следующий пакет
+         * @param out Пакет для записи (Packet::id берётся из объединённого пакета)
+         * @return bool true - пакет прочитан, false - записи закончились или структура нарушена
+         */
+        [[nodiscard]] bool next(Packet& out) noexcept;
+
+        /**
+         * @brief Проверка нарушения структуры объединённого пакета
+         */
+        [[nodiscard]] bool failed() const noexcept { return mFailed; }
+
+    private:
+        const Packet& mBatch; ///< Объединённый пакет
+        size_t mOffset = 0;   ///< Смещение следующей записи
+        bool mFailed = false; ///< Обнаружена повреждённая запись
+    };
+} // namespace net
+
+#endif // NET_COALESCING_H
@@ -0,0 +1,160 @@
+#ifndef NET_COMPLETION_H
+#define NET_COMPLETION_H
+
+#include "net/lockfree_queue.h"
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace net
+{
+    /**
+     * @file completion.h
+     * @brief Уведомления о завершении асинхронной отправки (Transport::sendAsync())
+     * @details Результат завершения:
+     * - ESP_OK - пакет передан драйверу (для BLE - принят очередью соединения)
+     * - код ошибки - постоянная ошибка отправки или исчерпаны попытки
+     * - ESP_ERR_TIMEOUT - истёк срок жизни пакета
+     * - ESP_ERR_INVALID_STATE - пакет удалён из очереди без отправки (clearQueue(), stop())
+     */
+
+    /// @brief Callback завершения отправки; вызывается из задачи, завершившей отправку (обычно рабочий поток)
+    using CompletionFunction = std::function<void(esp_err_t result)>;
+
+    /**
+     * @brief Идентификатор ячейки завершения (0 - нет)
+     */
+    using CompletionId = uint8_t;
+
+    class SendHandle;
+
+    /**
+     * @brief Пул ячеек завершения со счётчиком ссылок
+     * @details Ячейку совместно удерживают SendHandle и пакет в очереди. Завершение срабатывает
+     *          один раз: первый вызов complete() фиксирует результат, вызывает callback
+     *          и будит ожидающую задачу.
+     */
+    class CompletionPool
+    {
+    public:
+        static constexpr size_t CAPACITY = 16; ///< Количество одновременно ожидаемых отправок
+
+        CompletionPool(const CompletionPool&) = delete;
+        CompletionPool& operator=(const CompletionPool&) = delete;
+
+        /**
+         * @brief Получить общий пул
+         */
+        static CompletionPool& instance() noexcept;
+
+        /**
+         * @brief Выделить ячейку завершения
+         * @param callback Callback завершения (может быть пустым)
+         * @return SendHandle Дескриптор ожидания; при исчерпании пула - завершённый с ESP_ERR_NO_MEM
+         */
+        [[nodiscard]] SendHandle acquire(CompletionFunction callback) noexcept;
+
+        /**
+         * @brief Добавить ссылку на ячейку
+         */
+        void retain(CompletionId id) noexcept;
+
+        /**
+         * @brief Освободить ссылку на ячейку
+         */
+        void release(CompletionId id) noexcept;
+
+        /**
+         * @brief Завершить отправку (повторные вызовы игнорируются)
+         * @param id Ячейка завершения
+         * @param result Результат отправки
+         */
+        void complete(CompletionId id, esp_err_t result) noexcept;
+
+    private:
+        friend class SendHandle;
+
+        /**
+         * @brief Ячейка завершения
+         */
+        struct Slot
+        {
+            /// @brief Состояние отправки
+            enum State : uint8_t
+            {
+                PENDING,    ///< Ожидает завершения
+                COMPLETING, ///< Результат записывается
+                DONE        ///< Завершена
+            };
+
+            std::atomic<uint8_t> refs{};        ///< Счётчик ссылок
+            std::atomic<uint8_t> state{};       ///< Состояние (State)
+            esp_err_t result = ESP_OK;          ///< Результат отправки
+            CompletionFunction callback;        ///< Callback завершения
+            StaticSemaphore_t signalBuffer{};   ///< Память семафора ожидания
+            SemaphoreHandle_t signal = nullptr; ///< Семафор ожидания
+        };
+
+        CompletionPool() noexcept;
+
+        [[nodiscard]] Slot& slot(CompletionId id) noexcept { return mSlots[id - 1]; }
+
+        std::array<Slot, CAPACITY> mSlots;           ///< Ячейки
+        LockFreeQueue<CompletionId, CAPACITY> mFree; ///< Свободные ячейки
+    };
+
+    /**
+     * @brief Дескриптор ожидания асинхронной отправки
+     * @details Только перемещаемый. Уничтожение дескриптора не отменяет отправку и callback.
+     */
+    class SendHandle
+    {
+    public:
+        SendHandle() noexcept = default;
+        SendHandle(SendHandle&& other) noexcept;
+        SendHandle& operator=(SendHandle&& other) noexcept;
+        SendHandle(const SendHandle&) = delete;
+        SendHandle& operator=(const SendHandle&) = delete;
+        ~SendHandle();
+
+        /**
+         * @brief Проверка завершения отправки
+         */
+        [[nodiscard]] bool ready() const noexcept;
+
+        /**
+         * @brief Результат отправки
+         * @return esp_err_t Результат или ESP_ERR_INVALID_STATE, если отправка ещё не завершена
+         */
+        [[nodiscard]] esp_err_t result() const noexcept;
+
+        /**
+         * @brief Ожидать завершения отправки
+         * @param timeout Максимальное время ожидания
+         * @return esp_err_t Результат отправки или ESP_ERR_TIMEOUT, если она не завершилась
+         * @note Результат ESP_ERR_TIMEOUT (истёк срок жизни пакета) отличается от таймаута ожидания по ready()
+         */
+        esp_err_t wait(TickType_t timeout = portMAX_DELAY) const noexcept;
+
+        /**
+         * @brief Идентификатор ячейки завершения (0 - дескриптор без ячейки)
+         */
+        [[nodiscard]] CompletionId id() const noexcept { return mId; }
+
+    private:
+        friend class CompletionPool;
+
+        SendHandle(CompletionId id, esp_err_t immediate) noexcept : mId(id), mImmediate(immediate) {}
+
+        CompletionId mId = 0;                         ///< Ячейка завершения
+        esp_err_t mImmediate = ESP_ERR_INVALID_STATE; ///< Результат дескриптора без ячейки
+    };
+} // namespace net
+
+#endif // NET_COMPLETION_H
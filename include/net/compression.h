@@ -0,0 +1,75 @@
+#ifndef NET_COMPRESSION_H
+#define NET_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace net
+{
+    /**
+     * @file compression.h
+     * @brief Сжатие полезной нагрузки пакетов (LZ77 с окном в пределах пакета)
+     * @details Каждый пакет сжимается независимо, поэтому потеря пакета не нарушает распаковку следующих.
+     *          Сжатая нагрузка начинается с байта формата (COMPRESSION_RAW / COMPRESSION_LZ),
+     *          за которым следует поток токенов:
+     * - 0LLLLLLL - L + 1 литералов (1-128 байт) следуют за токеном
+     * - 1LLLLLOO OOOOOOOO - повтор L + 3 байт (3-34) со смещением O + 1 (1-1024) назад
+     *
+     * Компрессор использует хэш-таблицу фиксированного размера на стеке (HASH_SIZE * 2 байт),
+     * распаковка не требует дополнительной памяти.
+     */
+
+    /**
+     * @brief Режим сжатия полезной нагрузки
+     */
+    enum class Compression : uint8_t
+    {
+        NONE, ///< Без сжатия, пакет передаётся как есть
+        LZ    ///< Сжатие LZ с байтом формата; несжимаемые данные передаются без сжатия
+    };
+
+    /// @brief Байт формата: данные не сжаты
+    constexpr uint8_t COMPRESSION_RAW = 0x00;
+
+    /// @brief Байт формата: данные сжаты LZ
+    constexpr uint8_t COMPRESSION_LZ = 0x01;
+
+    /// @brief Накладные расходы сжатого формата (байт формата)
+    constexpr size_t COMPRESSION_OVERHEAD = 1;
+
+    /**
+     * @brief Сжать данные LZ (без байта формата)
+     * @param data Исходные данные
+     * @param out Буфер результата
+     * @return size_t Размер сжатых данных, 0 - результат не помещается в out
+     */
+    [[nodiscard]] size_t lzCompress(std::span<const uint8_t> data, std::span<uint8_t> out) noexcept;
+
+    /**
+     * @brief Распаковать данные LZ (без байта формата)
+     * @param data Сжатые данные
+     * @param out Буфер результата
+     * @return size_t Размер распакованных данных, 0 - данные повреждены или не помещаются в out
+     */
+    [[nodiscard]] size_t lzDecompress(std::span<const uint8_t> data, std::span<uint8_t> out) noexcept;
+
+    /**
+     * @brief Сжать полезную нагрузку пакета с выбором формата
+     * @details Если сжатие не уменьшает размер, данные копируются без сжатия (COMPRESSION_RAW)
+     * @param data Исходные данные
+     * @param out Буфер результата (байт формата и данные)
+     * @return size_t Размер результата, 0 - не помещается в out даже без сжатия
+     */
+    [[nodiscard]] size_t compressPayload(std::span<const uint8_t> data, std::span<uint8_t> out) noexcept;
+
+    /**
+     * @brief Восстановить полезную нагрузку пакета
+     * @param data Байт формата и данные
+     * @param out Буфер результата
+     * @return size_t Размер восстановленных данных, 0 - неизвестный формат или повреждённые данные
+     */
+    [[nodiscard]] size_t decompressPayload(std::span<const uint8_t> data, std::span<uint8_t> out) noexcept;
+} // namespace net
+
+#endif // NET_COMPRESSION_H
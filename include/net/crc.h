@@ -0,0 +1,88 @@
+#ifndef NET_CRC_H
+#define NET_CRC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace net
+{
+    /**
+     * @file crc.h
+     * @brief Контрольные суммы CRC16/CRC32 и трейлер целостности пакетов
+     * @details Алгоритмы совместимы с функциями ПЗУ ESP32 (esp_rom_crc32_le / esp_rom_crc16_le):
+     * - CRC32: IEEE 802.3 (полином 0x04C11DB7, отражённый), контрольное значение "123456789" - 0xCBF43926
+     * - CRC16: X.25 (полином 0x1021, отражённый), контрольное значение "123456789" - 0x906E
+     *
+     * Параметр crc позволяет считать сумму по частям: crc32(b, crc32(a)) == crc32(a || b).
+     */
+
+    /**
+     * @brief Контроль целостности пакета
+     */
+    enum class Integrity : uint8_t
+    {
+        NONE,  ///< Без контрольной суммы
+        CRC16, ///< Трейлер CRC16 (2 байта, little-endian)
+        CRC32  ///< Трейлер CRC32 (4 байта, little-endian)
+    };
+
+    /// @brief Максимальный размер трейлера целостности
+    constexpr size_t MAX_INTEGRITY_SIZE = 4;
+
+    /**
+     * @brief Размер трейлера целостности
+     */
+    [[nodiscard]] constexpr size_t integritySize(const Integrity integrity) noexcept
+    {
+        switch (integrity)
+        {
+        case Integrity::CRC16: return 2;
+        case Integrity::CRC32: return 4;
+        default: return 0;
+        }
+    }
+
+    /**
+     * @brief CRC32 (функция ПЗУ на ESP32, иначе crc32Table)
+     * @param data Данные
+     * @param crc Сумма предыдущей части данных (0 - начало)
+     */
+    [[nodiscard]] uint32_t crc32(std::span<const uint8_t> data, uint32_t crc = 0) noexcept;
+
+    /**
+     * @brief CRC16 (функция ПЗУ на ESP32, иначе crc16Table)
+     * @param data Данные
+     * @param crc Сумма предыдущей части данных (0 - начало)
+     */
+    [[nodiscard]] uint16_t crc16(std::span<const uint8_t> data, uint16_t crc = 0) noexcept;
+
+    /**
+     * @brief Переносимый табличный CRC32 (slice-by-8: 8 байт за итерацию)
+     */
+    [[nodiscard]] uint32_t crc32Table(std::span<const uint8_t> data, uint32_t crc = 0) noexcept;
+
+    /**
+     * @brief Переносимый табличный CRC16 (slice-by-8: 8 байт за итерацию)
+     */
+    [[nodiscard]] uint16_t crc16Table(std::span<const uint8_t> data, uint16_t crc = 0) noexcept;
+
+    /**
+     * @brief Дописать трейлер целостности после данных
+     * @param integrity Вид контрольной суммы
+     * @param buffer Буфер: данные в начале и место под трейлер после них
+     * @param size Размер данных
+     * @return size_t Размер данных с трейлером, 0 - в буфере нет места
+     */
+    [[nodiscard]] size_t appendIntegrity(Integrity integrity, std::span<uint8_t> buffer, size_t size) noexcept;
+
+    /**
+     * @brief Проверить трейлер целостности
+     * @param integrity Вид контрольной суммы
+     * @param frame Данные вместе с трейлером
+     * @return size_t Размер данных без трейлера, 0 - сумма не совпала или кадр короче трейлера
+     */
+    [[nodiscard]] size_t verifyIntegrity(Integrity integrity, std::span<const uint8_t> frame) noexcept;
+} // namespace net
+
+#endif // NET_CRC_H
@@ -0,0 +1,85 @@
+#ifndef NET_FRAGMENT_H
+#define NET_FRAGMENT_H
+
+#include "net/packet.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace net
+{
+    /**
+     * @file fragment.h
+     * @brief Разбиение пакетов на фрагменты по MTU и их сборка
+     * @details Каждый фрагмент начинается с однобайтового заголовка:
+     * - бит 7 - первый фрагмент пакета
+     * - бит 6 - последний фрагмент пакета
+     * - биты 0-5 - номер фрагмента в пакете (по модулю 64)
+     *
+     * Пакет, помещающийся в один фрагмент, передаётся с флагами FIRST | LAST.
+     */
+
+    /**
+     * @brief Заголовок фрагмента
+     */
+    struct FragmentHeader
+    {
+        static constexpr uint8_t FIRST = 0x80;      ///< Первый фрагмент пакета
+        static constexpr uint8_t LAST = 0x40;       ///< Последний фрагмент пакета
+        static constexpr uint8_t INDEX_MASK = 0x3F; ///< Маска номера фрагмента
+        static constexpr size_t SIZE = 1;           ///< Размер заголовка (байт)
+    };
+
+    /**
+     * @brief Записать очередной фрагмент пакета
+     * @param packet Исходный пакет
+     * @param offset Смещение первого байта фрагмента в данных пакета
+     * @param index Номер фрагмента в пакете
+     * @param out Буфер фрагмента (заголовок + данные), размер определяет максимальный фрагмент
+     * @return size_t Количество байт данных пакета, помещённых во фрагмент (0 - буфер слишком мал)
+     */
+    [[nodiscard]] size_t writeFragment(const Packet& packet, size_t offset, uint8_t index,
+                                       std::span<uint8_t> out) noexcept;
+
+    /**
+     * @brief Сборка пакета из последовательности фрагментов
+     */
+    class Reassembler
+    {
+    public:
+        /**
+         * @brief Результат обработки фрагмента
+         */
+        enum class Result
+        {
+            INCOMPLETE, ///< Фрагмент принят, пакет ещё не собран
+            COMPLETE,   ///< Пакет собран и доступен через packet()
+            ERROR       ///< Нарушена последовательность или переполнение; сборка сброшена
+        };
+
+        /**
+         * @brief Обработать принятый фрагмент
+         * @param data Фрагмент вместе с заголовком
+         * @return Result Результат обработки
+         */
+        [[nodiscard]] Result push(std::span<const uint8_t> data) noexcept;
+
+        /**
+         * @brief Собранный пакет (действителен после Result::COMPLETE до следующего push)
+         */
+        [[nodiscard]] const Packet& packet() const noexcept { return mPacket; }
+
+        /**
+         * @brief Сбросить незавершённую сборку
+         */
+        void reset() noexcept;
+
+    private:
+        Packet mPacket;          ///< Собираемый пакет
+        uint8_t mNextIndex = 0;  ///< Ожидаемый номер следующего фрагмента
+        bool mActive = false;    ///< Идёт сборка пакета
+    };
+} // namespace net
+
+#endif // NET_FRAGMENT_H
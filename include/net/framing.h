@@ -0,0 +1,200 @@
+#ifndef NET_FRAMING_H
+#define NET_FRAMING_H
+
+#include "net/packet.h"
+#include "net/crc.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace net
+{
+    /**
+     * @file framing.h
+     * @brief Кадрирование пакетов в байтовом потоке (UART, USB-JTAG)
+     * @details Кадр COBS: данные пакета, закодированные Consistent Overhead Byte Stuffing,
+     *          и завершающий байт 0x00. Внутри кадра нулевые байты не встречаются,
+     *          поэтому приёмник восстанавливает границы пакетов после любого искажения потока.
+     *          Перед кодированием к данным может добавляться трейлер CRC (см. crc.h).
+     */
+
+    /**
+     * @brief Режим кадрирования потока
+     */
+    enum class Framing : uint8_t
+    {
+        RAW, ///< Без кадрирования: пакетом считается всё, что прочитано за один вызов
+        COBS ///< Кадры COBS с разделителем 0x00
+    };
+
+    /// @brief Разделитель кадров COBS
+    constexpr uint8_t COBS_DELIMITER = 0x00;
+
+    /**
+     * @brief Максимальный размер данных после кодирования COBS (без разделителя)
+     * @param size Размер исходных данных
+     */
+    [[nodiscard]] constexpr size_t cobsMaxEncodedSize(const size_t size) noexcept
+    {
+        return size + size / 254 + 1;
+    }
+
+    /**
+     * @brief Закодировать данные COBS
+     * @param data Исходные данные
+     * @param out Буфер результата (не меньше cobsMaxEncodedSize(data.size()))
+     * @return size_t Размер закодированных данных без разделителя, 0 - буфер слишком мал
+     */
+    [[nodiscard]] size_t cobsEncode(std::span<const uint8_t> data, std::span<uint8_t> out) noexcept;
+
+    /**
+     * @brief Декодировать данные COBS
+     * @param data Закодированные данные без разделителя
+     * @param out Буфер результата (может совпадать с data - декодирование на месте)
+     * @return size_t Размер декодированных данных, 0 - нарушена структура кадра или буфер слишком мал
+     */
+    [[nodiscard]] size_t cobsDecode(std::span<const uint8_t> data, std::span<uint8_t> out) noexcept;
+
+    /**
+     * @brief Потоковый декодер кадров COBS
+     * @details Принимает поток произвольными порциями. Повреждённый или слишком длинный кадр
+     *          отбрасывается целиком, приём продолжается со следующего разделителя.
+     */
+    class FrameDecoder
+    {
+    public:
+        /// @brief Максимальный размер декодированного кадра (пакет и трейлер целостности)
+        static constexpr size_t MAX_FRAME_SIZE = MAX_MTU + MAX_INTEGRITY_SIZE;
+
+        /**
+         * @brief Обработать очередную порцию потока
+         * @param data Принятые байты
+         * @param onFrame Обработчик кадра, вызывается как onFrame(std::span<const uint8_t>)
+         *                для каждого собранного кадра; данные действительны только внутри вызова
+         */
+        template <typename Handler>
+        void feed(const std::span<const uint8_t> data, Handler&& onFrame)
+        {
+            for (const uint8_t byte : data)
+            {
+                if (byte != COBS_DELIMITER)
+                {
+                    if (mSize < mBuffer.size()) mBuffer[mSize++] = byte;
+                    else mOverflow = true;
+                    continue;
+                }
+
+                if (const auto frame = complete(); !frame.empty()) onFrame(frame);
+            }
+        }
+
+        /**
+         * @brief Сбросить незавершённый кадр
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Количество отброшенных кадров с момента создания
+         */
+        [[nodiscard]] size_t errors() const noexcept { return mErrors; }
+
+    private:
+        /**
+         * @brief Завершить кадр по разделителю
+         * @return std::span<const uint8_t> Декодированный кадр или пустой диапазон
+         */
+        [[nodiscard]] std::span<const uint8_t> complete() noexcept;
+
+        std::array<uint8_t, cobsMaxEncodedSize(MAX_FRAME_SIZE)> mBuffer{}; ///< Накопленный кадр
+        size_t mSize = 0;                                                  ///< Размер накопленного кадра
+        size_t mErrors = 0;                                                ///< Отброшенные кадры
+        bool mOverflow = false;                                            ///< Кадр превысил размер буфера
+    };
+
+    /**
+     * @brief Кодек пакетов для байтового потока: кадрирование и контроль целостности
+     * @details Не потокобезопасен: кодирование и декодирование выполняет рабочий поток транспорта,
+     *          настройки меняются только при остановленном потоке
+     */
+    class StreamCodec
+    {
+    public:
+        /// @brief Максимальный размер кадра в потоке (с разделителем)
+        static constexpr size_t MAX_ENCODED_SIZE = cobsMaxEncodedSize(FrameDecoder::MAX_FRAME_SIZE) + 1;
+
+        /**
+         * @brief Установить режим кадрирования (незавершённый принятый кадр сбрасывается)
+         */
+        void setFraming(Framing framing) noexcept;
+
+        /**
+         * @brief Получить режим кадрирования
+         */
+        [[nodiscard]] Framing framing() const noexcept { return mFraming; }
+
+        /**
+         * @brief Установить контроль целостности
+         * @note Действует только вместе с Framing::COBS: без кадрирования трейлер не отделить от потока
+         */
+        void setIntegrity(Integrity integrity) noexcept { mIntegrity = integrity; }
+
+        /**
+         * @brief Получить контроль целостности
+         */
+        [[nodiscard]] Integrity integrity() const noexcept { return mIntegrity; }
+
+        /**
+         * @brief Закодировать пакет для записи в поток
+         * @param packet Пакет
+         * @return std::span<const uint8_t> Байты для записи (действительны до следующего вызова)
+         */
+        [[nodiscard]] std::span<const uint8_t> encode(const Packet& packet) noexcept;
+
+        /**
+         * @brief Обработать принятую порцию потока
+         * @param data Принятые байты
+         * @param onPacket Обработчик пакета, вызывается как onPacket(const Packet&) для каждого
+         *                 принятого пакета (в режиме RAW - один пакет на порцию)
+         */
+        template <typename Handler>
+        void decode(const std::span<const uint8_t> data, Handler&& onPacket)
+        {
+            if (mFraming == Framing::RAW)
+            {
+                if (mPacket.setPayload(data.data(), data.size())) onPacket(mPacket);
+                return;
+            }
+
+            mDecoder.feed(data, [&](const std::span<const uint8_t> frame)
+            {
+                const size_t size = verifyIntegrity(mIntegrity, frame);
+                if (size == 0 || !mPacket.setPayload(frame.data(), size))
+                {
+                    mCorrupted++;
+                    return;
+                }
+
+                onPacket(mPacket);
+            });
+        }
+
+        /**
+         * @brief Количество отброшенных кадров (нарушение кадрирования или контрольной суммы)
+         */
+        [[nodiscard]] size_t errors() const noexcept { return mDecoder.errors() + mCorrupted; }
+
+    private:
+        Framing mFraming = Framing::RAW;        ///< Режим кадрирования
+        Integrity mIntegrity = Integrity::NONE; ///< Контроль целостности
+        FrameDecoder mDecoder;                  ///< Декодер принимаемых кадров
+        size_t mCorrupted = 0;                  ///< Отброшенные кадры с неверным содержимым
+
+        Packet mPacket;                                             ///< Принятый пакет
+        std::array<uint8_t, FrameDecoder::MAX_FRAME_SIZE> mPlain{}; ///< Пакет с трейлером перед кодированием
+        std::array<uint8_t, MAX_ENCODED_SIZE> mEncoded{};           ///< Закодированный кадр
+    };
+} // namespace net
+
+#endif // NET_FRAMING_H
@@ -0,0 +1,144 @@
+#ifndef NET_LOCKFREE_QUEUE_H
+#define NET_LOCKFREE_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace net
+{
+    /**
+     * @file lockfree_queue.h
+     * @brief Ограниченная неблокирующая очередь для нескольких производителей и потребителей
+     */
+
+    /**
+     * @brief Неблокирующая кольцевая очередь фиксированного размера (алгоритм Вьюкова)
+     * @details Каждая ячейка хранит номер последовательности, по которому производитель
+     *          и потребитель определяют, свободна ли она. Захват позиции - одна операция CAS,
+     *          без конкуренции push() и pop() выполняются за постоянное время без блокировок.
+     *          Подходит для вызова из любых задач; на ESP32-C3 атомарные операции
+     *          эмулируются короткой критической секцией без перехода в ожидание.
+     * @tparam T Тип элемента (копируемый, желательно тривиальный)
+     * @tparam N Ёмкость очереди (степень двойки)
+     */
+    template <typename T, size_t N>
+    class LockFreeQueue
+    {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "Ёмкость очереди должна быть степенью двойки");
+
+    public:
+        LockFreeQueue() noexcept
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                mCells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        LockFreeQueue(const LockFreeQueue&) = delete;
+        LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+        /**
+         * @brief Поместить элемент в конец очереди
+         * @return bool false - очередь заполнена
+         */
+        [[nodiscard]] bool push(const T& value) noexcept
+        {
+            size_t pos = mTail.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Cell& cell = mCells[pos & MASK];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+                if (diff == 0)
+                {
+                    if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.value = value;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = mTail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Извлечь элемент из начала очереди
+         * @return bool false - очередь пуста
+         */
+        [[nodiscard]] bool pop(T& value) noexcept
+        {
+            size_t pos = mHead.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Cell& cell = mCells[pos & MASK];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+                if (diff == 0)
+                {
+                    if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        value = cell.value;
+                        cell.sequence.store(pos + N, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = mHead.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Получить количество элементов
+         * @note При одновременных push()/pop() значение приблизительное
+         */
+        [[nodiscard]] size_t size() const noexcept
+        {
+            const size_t head = mHead.load(std::memory_order_acquire);
+            const size_t tail = mTail.load(std::memory_order_acquire);
+            const auto count = static_cast<intptr_t>(tail - head);
+            return count <= 0 ? 0 : count >= static_cast<intptr_t>(N) ? N : static_cast<size_t>(count);
+        }
+
+        /**
+         * @brief Ёмкость очереди
+         */
+        [[nodiscard]] static constexpr size_t capacity() noexcept { return N; }
+
+    private:
+        static constexpr size_t MASK = N - 1; ///< Маска индекса ячейки
+
+        /**
+         * @brief Ячейка очереди
+         */
+        struct Cell
+        {
+            std::atomic<size_t> sequence{}; ///< Номер последовательности ячейки
+            T value{};                      ///< Элемент
+        };
+
+        std::array<Cell, N> mCells;    ///< Ячейки очереди
+        std::atomic<size_t> mHead = 0; ///< Позиция потребителя
+        std::atomic<size_t> mTail = 0; ///< Позиция производителя
+    };
+} // namespace net
+
+#endif // NET_LOCKFREE_QUEUE_H
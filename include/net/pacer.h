@@ -0,0 +1,122 @@
+#ifndef NET_PACER_H
+#define NET_PACER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace net
+{
+    /**
+     * @file pacer.h
+     * @brief Ограничение скорости отправки по алгоритму token bucket
+     */
+
+    /**
+     * @brief Политика ограничения скорости отправки
+     */
+    struct PacingPolicy
+    {
+        /**
+         * @brief Единица измерения токенов
+         */
+        enum class Unit
+        {
+            PACKETS, ///< Один токен - один пакет
+            BYTES    ///< Один токен - один байт данных
+        };
+
+        uint32_t rate = 50;        ///< Скорость пополнения (токенов в секунду), 0 - без ограничения
+        uint32_t burst = 1;        ///< Ёмкость корзины (токенов)
+        Unit unit = Unit::PACKETS; ///< Единица измерения
+
+        /**
+         * @brief Отправка без ограничения скорости
+         */
+        [[nodiscard]] static constexpr PacingPolicy unpaced() noexcept
+        {
+            return {.rate = 0, .burst = 0, .unit = Unit::PACKETS};
+        }
+
+        /**
+         * @brief Ограничение по количеству пакетов
+         * @param rate Пакетов в секунду
+         * @param burst Максимальное количество пакетов подряд
+         */
+        [[nodiscard]] static constexpr PacingPolicy packets(const uint32_t rate, const uint32_t burst = 1) noexcept
+        {
+            return {.rate = rate, .burst = burst, .unit = Unit::PACKETS};
+        }
+
+        /**
+         * @brief Ограничение по объёму данных
+         * @param rate Байт в секунду
+         * @param burst Максимальный объём данных подряд (байт)
+         */
+        [[nodiscard]] static constexpr PacingPolicy bytes(const uint32_t rate, const uint32_t burst) noexcept
+        {
+            return {.rate = rate, .burst = burst, .unit = Unit::BYTES};
+        }
+
+        /**
+         * @brief Проверка отсутствия ограничения скорости
+         */
+        [[nodiscard]] constexpr bool isUnpaced() const noexcept { return rate == 0; }
+    };
+
+    /**
+     * @brief Ограничитель скорости отправки (token bucket)
+     * @details Отправка разрешена, пока в корзине есть хотя бы часть токена;
+     *          стоимость пакета списывается после отправки, поэтому баланс может уходить в минус.
+     *          Это позволяет не знать размер следующего пакета заранее и сохраняет среднюю скорость.
+     */
+    class Pacer
+    {
+    public:
+        /**
+         * @brief Конструктор ограничителя
+         * @param policy Начальная политика
+         */
+        explicit Pacer(const PacingPolicy& policy = {}) noexcept;
+
+        /**
+         * @brief Установить политику (корзина заполняется полностью)
+         * @param policy Новая политика
+         */
+        void setPolicy(const PacingPolicy& policy) noexcept;
+
+        /**
+         * @brief Получить текущую политику
+         */
+        [[nodiscard]] PacingPolicy policy() const noexcept;
+
+        /**
+         * @brief Время до разрешения следующей отправки
+         * @param now Текущее время (мкс)
+         * @return int64_t Задержка в микросекундах (0 - можно отправлять сейчас)
+         */
+        [[nodiscard]] int64_t delayUs(int64_t now) noexcept;
+
+        /**
+         * @brief Списать стоимость отправленного пакета
+         * @param bytes Размер пакета
+         * @param now Текущее время (мкс)
+         */
+        void consume(size_t bytes, int64_t now) noexcept;
+
+    private:
+        static constexpr int64_t SCALE = 1000000; ///< Токены хранятся в миллионных долях
+
+        /**
+         * @brief Пополнить корзину за прошедшее время
+         */
+        void refill(int64_t now) noexcept;
+
+        PacingPolicy mPolicy;      ///< Текущая политика
+        int64_t mTokens = 0;       ///< Баланс корзины (токены * SCALE)
+        int64_t mLastRefill = 0;   ///< Время последнего пополнения (мкс)
+        mutable std::mutex mMutex; ///< Мьютекс состояния
+    };
+} // namespace net
+
+#endif // NET_PACER_H
@@ -0,0 +1,261 @@
+#ifndef NET_PACKET_POOL_H
+#define NET_PACKET_POOL_H
+
+#include "net/packet.h"
+#include "net/lockfree_queue.h"
+#include "net/completion.h"
+
+#include <array>
+#include <atomic>
+
+namespace net
+{
+    /**
+     * @file packet_pool.h
+     * @brief Пул буферов пакетов фиксированного размера с подсчётом ссылок
+     */
+
+    /**
+     * @brief Ячейка пула пакетов
+     * @note Используется только через PacketRef и PacketPool
+     */
+    struct PacketSlot
+    {
+        Packet packet;                ///< Данные пакета
+        std::atomic<uint16_t> refs{}; ///< Счётчик ссылок
+        uint8_t attempts = 0;         ///< Количество неудачных попыток отправки
+        uint32_t enqueueTime = 0;     ///< Время постановки в очередь отправки (мкс, младшие 32 бита)
+        uint32_t deadline = 0;        ///< Срок отправки (мкс, младшие 32 бита, 0 - без срока)
+        CompletionId completion = 0;  ///< Ячейка завершения асинхронной отправки (0 - нет)
+        uint8_t reservation = 0;      ///< Резерв, из которого выделена ячейка (0 - общая часть пула)
+    };
+
+    /**
+     * @brief Дескриптор пакета из пула со счётчиком ссылок
+     * @details Копирование дескриптора не копирует данные пакета, а лишь увеличивает
+     *          счётчик ссылок. Ячейка возвращается в пул при уничтожении последнего дескриптора.
+     */
+    class PacketRef
+    {
+    public:
+        PacketRef() noexcept = default;
+        PacketRef(const PacketRef& other) noexcept;
+        PacketRef(PacketRef&& other) noexcept;
+        PacketRef& operator=(const PacketRef& other) noexcept;
+        PacketRef& operator=(PacketRef&& other) noexcept;
+        ~PacketRef();
+
+        /**
+         * @brief Проверка, что дескриптор ссылается на ячейку пула
+         */
+        explicit operator bool() const noexcept { return mSlot != nullptr; }
+
+        Packet& operator*() const noexcept { return mSlot->packet; }
+        Packet* operator->() const noexcept { return &mSlot->packet; }
+
+        /**
+         * @brief Получить количество дескрипторов, ссылающихся на ячейку
+         * @return uint16_t Количество ссылок (0 для пустого дескриптора)
+         */
+        [[nodiscard]] uint16_t useCount() const noexcept;
+
+        /**
+         * @brief Получить количество неудачных попыток отправки пакета
+         * @return uint8_t Количество попыток (0 для нового пакета и пустого дескриптора)
+         */
+        [[nodiscard]] uint8_t attempts() const noexcept;
+
+        /**
+         * @brief Установить количество неудачных попыток отправки пакета
+         * @param attempts Новое значение счётчика
+         * @note Счётчик общий для всех дескрипторов ячейки
+         */
+        void setAttempts(uint8_t attempts) const noexcept;
+
+        /**
+         * @brief Получить время постановки пакета в очередь отправки
+         * @return uint32_t Младшие 32 бита esp_timer_get_time() (0 для пустого дескриптора)
+         */
+        [[nodiscard]] uint32_t enqueueTime() const noexcept;
+
+        /**
+         * @brief Установить время постановки пакета в очередь отправки
+         * @param time Младшие 32 бита esp_timer_get_time()
+         * @note Время общее для всех дескрипторов ячейки
+         */
+        void setEnqueueTime(uint32_t time) const noexcept;
+
+        /**
+         * @brief Получить срок отправки пакета
+         * @return uint32_t Младшие 32 бита esp_timer_get_time() (0 - без срока)
+         */
+        [[nodiscard]] uint32_t deadline() const noexcept;
+
+        /**
+         * @brief Установить срок отправки пакета
+         * @param deadline Младшие 32 бита esp_timer_get_time(), после которых пакет не отправляется (0 - без срока)
+         * @note Срок должен быть не дальше 35 минут от текущего времени (половина периода 32-битного счётчика)
+         */
+        void setDeadline(uint32_t deadline) const noexcept;
+
+        /**
+         * @brief Проверка истечения срока отправки
+         * @param now Младшие 32 бита esp_timer_get_time()
+         * @return true если срок задан и наступил
+         */
+        [[nodiscard]] bool isExpired(uint32_t now) const noexcept;
+
+        /**
+         * @brief Получить ячейку завершения асинхронной отправки
+         * @return CompletionId Ячейка (0 - пакет отправлен без ожидания завершения)
+         */
+        [[nodiscard]] CompletionId completion() const noexcept;
+
+        /**
+         * @brief Привязать ячейку завершения к пакету
+         * @param id Ячейка; пакет становится владельцем одной ссылки на неё
+         * @note Если ячейка пула освобождается с привязанной ячейкой завершения,
+         *       отправка завершается с ESP_ERR_INVALID_STATE
+         */
+        void setCompletion(CompletionId id) const noexcept;
+
+        /**
+         * @brief Освободить ссылку на ячейку
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Передать владение ссылкой в виде сырого указателя (для очередей FreeRTOS)
+         * @return PacketSlot* Указатель на ячейку; дескриптор становится пустым
+         * @warning Полученный указатель должен быть возвращён через adopt()
+         */
+        [[nodiscard]] PacketSlot* release() noexcept;
+
+        /**
+         * @brief Принять владение ссылкой, ранее переданной через release()
+         * @param slot Указатель на ячейку
+         * @return PacketRef Дескриптор, владеющий ссылкой
+         */
+        [[nodiscard]] static PacketRef adopt(PacketSlot* slot) noexcept;
+
+    private:
+        friend class PacketPool;
+
+        explicit PacketRef(PacketSlot* slot) noexcept : mSlot(slot) {}
+
+        PacketSlot* mSlot = nullptr; ///< Ячейка пула
+    };
+
+    /**
+     * @brief Пул буферов пакетов фиксированного размера (slab)
+     * @details Общий для всех транспортов. Очереди отправки хранят только дескрипторы,
+     *          поэтому пакет копируется не более одного раза - при постановке в очередь.
+     *          Выделение и освобождение ячеек не блокируют вызывающую задачу.
+     *
+     *          Часть ячеек может быть зарезервирована за владельцем (транспортом): ячейки резерва
+     *          выделяются только ему, сверх резерва владелец пользуется общей частью пула.
+     *          Поэтому накопившиеся пакеты одного транспорта не лишают ячеек остальные.
+     */
+    class PacketPool
+    {
+    public:
+        static constexpr size_t CAPACITY = 32;        ///< Количество ячеек в пуле
+        static constexpr size_t MAX_RESERVATIONS = 8; ///< Максимальное количество резервов
+
+        /// @brief Идентификатор резерва (0 - без резерва, только общая часть пула)
+        using ReservationId = uint8_t;
+
+        PacketPool(const PacketPool&) = delete;
+        PacketPool& operator=(const PacketPool&) = delete;
+
+        /**
+         * @brief Получить общий пул пакетов
+         * @return PacketPool& Единственный экземпляр пула
+         */
+        static PacketPool& instance() noexcept;
+
+        /**
+         * @brief Зарезервировать ячейки за владельцем
+         * @param count Количество ячеек
+         * @return ReservationId Резерв или 0, если свободных незарезервированных ячеек
+         *         или записей резервов не хватает
+         */
+        [[nodiscard]] ReservationId reserve(size_t count) noexcept;
+
+        /**
+         * @brief Вернуть резерв в общую часть пула
+         * @param id Резерв (0 игнорируется)
+         * @note Выделенные из резерва ячейки остаются действительными и возвращаются в общую часть
+         *       при освобождении; запись резерва переиспользуется после освобождения всех его ячеек
+         */
+        void unreserve(ReservationId id) noexcept;
+
+        /**
+         * @brief Выделить пустую ячейку
+         * @param reservation Резерв владельца (0 - только общая часть пула)
+         * @return PacketRef Дескриптор ячейки или пустой дескриптор, если пул исчерпан
+         */
+        [[nodiscard]] PacketRef acquire(ReservationId reservation = 0) noexcept;
+
+        /**
+         * @brief Выделить ячейку и скопировать в неё пакет
+         * @param packet Исходный пакет (копируются только значимые байты)
+         * @param reservation Резерв владельца (0 - только общая часть пула)
+         * @return PacketRef Дескриптор ячейки или пустой дескриптор, если пул исчерпан
+         *         или размер пакета больше MAX_MTU
+         */
+        [[nodiscard]] PacketRef acquire(const Packet& packet, ReservationId reservation = 0) noexcept;
+
+        /**
+         * @brief Получить количество свободных ячеек
+         * @return size_t Количество свободных ячеек (включая зарезервированные)
+         */
+        [[nodiscard]] size_t available() const noexcept;
+
+        /**
+         * @brief Получить количество свободных ячеек общей части пула
+         * @return size_t Количество ячеек, доступных без резерва
+         */
+        [[nodiscard]] size_t shared() const noexcept;
+
+    private:
+        friend class PacketRef;
+
+        PacketPool() noexcept;
+
+        /**
+         * @brief Вернуть ячейку в пул
+         */
+        void release(PacketSlot* slot) noexcept;
+
+        /**
+         * @brief Учесть выделение ячейки: из резерва, если он не израсходован, иначе из общей части
+         * @return bool false - общая часть исчерпана
+         */
+        bool take(ReservationId reservation) noexcept;
+
+        /**
+         * @brief Учесть возврат ячейки в резерв или в общую часть
+         */
+        void give(ReservationId reservation) noexcept;
+
+        /**
+         * @brief Занять ячейку общей части пула
+         */
+        bool takeShared() noexcept;
+
+        /**
+         * @brief Состояние резерва: старшие 16 бит - размер, младшие - выделено ячеек
+         * @details Размер и счётчик меняются одной атомарной операцией, поэтому выделение
+         *          и освобождение из разных задач не нарушают учёт общей части пула
+         */
+        using ReservationState = std::atomic<uint32_t>;
+
+        std::array<PacketSlot, CAPACITY> mSlots;                      ///< Ячейки пула
+        LockFreeQueue<PacketSlot*, CAPACITY> mFree;                   ///< Свободные ячейки
+        std::atomic<size_t> mShared = CAPACITY;                       ///< Свободные ячейки вне резервов
+        std::array<ReservationState, MAX_RESERVATIONS> mReservations{}; ///< Резервы владельцев
+    };
+} // namespace net
+
+#endif // NET_PACKET_POOL_H
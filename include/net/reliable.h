@@ -0,0 +1,276 @@
+#ifndef NET_RELIABLE_H
+#define NET_RELIABLE_H
+
+#include "net/packet_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+namespace net
+{
+    /**
+     * @file reliable.h
+     * @brief Надёжная доставка со скользящим окном (ARQ с накопительными и выборочными подтверждениями)
+     * @details Кадры (первый байт - тип):
+     * - DATA:      D0 seq данные
+     * - DATA_SYNC: D1 seq epoch base данные - начало эпохи; base - старейший номер окна отправителя,
+     *              получатель принимает его как ожидаемый
+     * - ACK:       A0 epoch expected bitmap(2 байта, младший первым)
+     *
+     * expected - следующий ожидаемый номер (все предыдущие доставлены), бит i bitmap - кадр
+     * expected + 1 + i принят вне очереди. Номера 8-битные, окно не больше MAX_WINDOW.
+     * Эпоха меняется при каждом сбросе сессии и отказе от кадров, поэтому подтверждения
+     * старой сессии не освобождают кадры новой. Получатель игнорирует DATA до первого DATA_SYNC.
+     * Ожидаемый номер берётся из base, а не из seq кадра: потеря первого DATA_SYNC эпохи
+     * не пропускает его, а приводит к повторной передаче.
+     */
+
+    /**
+     * @brief Политика надёжной доставки
+     * @details Таймер повторной передачи вычисляется по измеренному времени подтверждения
+     *          (RFC 6298: SRTT + 4 * RTTVAR) и удваивается при истечении таймера старейшего кадра окна
+     */
+    struct ReliablePolicy
+    {
+        static constexpr uint8_t MAX_WINDOW = 16; ///< Максимальный размер окна
+
+        bool enabled = false;           ///< Надёжная доставка включена
+        uint8_t window = 8;             ///< Кадров в пути без подтверждения (1..MAX_WINDOW)
+        uint32_t initialRtoUs = 250000; ///< Таймер повторной передачи до первого измерения (мкс)
+        uint32_t minRtoUs = 20000;      ///< Минимальный таймер повторной передачи (мкс)
+        uint32_t maxRtoUs = 2000000;    ///< Максимальный таймер повторной передачи (мкс)
+        uint8_t maxRetransmits = 8;     ///< Повторных передач кадра до отказа
+
+        /**
+         * @brief Доставка без подтверждений
+         */
+        [[nodiscard]] static constexpr ReliablePolicy disabled() noexcept
+        {
+            return {};
+        }
+
+        /**
+         * @brief Надёжная доставка со скользящим окном
+         * @param window Кадров в пути без подтверждения (1..MAX_WINDOW)
+         */
+        [[nodiscard]] static constexpr ReliablePolicy windowed(const uint8_t window = 8) noexcept
+        {
+            return {.enabled = true, .window = window};
+        }
+    };
+
+    /**
+     * @brief Состояние надёжной доставки одного транспорта
+     * @details Окно отправки используется рабочим потоком и обработкой подтверждений,
+     *          окно приёма - задачей приёма; каждое защищено своим мьютексом.
+     *          Кадры окна отправки - дескрипторы пула, поэтому повторная передача не копирует данные.
+     * @note Сессия одна на транспорт (соединение точка-точка): подтверждения адресуются
+     *       Packet::id последнего принятого кадра данных
+     */
+    class ReliableSession
+    {
+    public:
+        static constexpr size_t MAX_OVERHEAD = 4; ///< Максимальный заголовок кадра данных (байт)
+
+        /**
+         * @brief Тип кадра
+         */
+        enum class FrameType : uint8_t
+        {
+            DATA = 0xD0,      ///< Кадр данных
+            DATA_SYNC = 0xD1, ///< Кадр данных, начинающий сессию
+            ACK = 0xA0        ///< Подтверждение
+        };
+
+        /// @brief Callback завершения кадра окна отправки (delivered - кадр подтверждён получателем)
+        using ResolveFunction = std::function<void(PacketRef& frame, bool delivered)>;
+
+        ReliableSession() noexcept;
+
+        /**
+         * @brief Установить политику и сбросить сессию
+         */
+        void setPolicy(const ReliablePolicy& policy) noexcept;
+
+        /**
+         * @brief Получить политику
+         */
+        [[nodiscard]] ReliablePolicy policy() const noexcept;
+
+        /**
+         * @brief Сбросить сессию: освободить кадры обоих окон и начать новую эпоху
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Определить тип кадра
+         * @return std::optional<FrameType> Тип или nullopt для некорректного кадра
+         */
+        [[nodiscard]] static std::optional<FrameType> frameType(const Packet& frame) noexcept;
+
+        // ---- Отправка ----
+
+        /**
+         * @brief Проверка свободного места в окне отправки
+         */
+        [[nodiscard]] bool canSend() const noexcept;
+
+        /**
+         * @brief Оформить пакет кадром данных и поместить его в окно отправки
+         * @param payload Пакет; при успехе перемещается (или копируется, если ячейка разделяется)
+         * @param now Текущее время (мкс)
+         * @return PacketRef Кадр для отправки или пустой дескриптор (окно заполнено,
+         *         пул исчерпан); тогда payload не изменяется
+         */
+        [[nodiscard]] PacketRef wrap(PacketRef& payload, int64_t now) noexcept;
+
+        /**
+         * @brief Получить кадр, таймер которого истёк, для повторной передачи
+         * @param now Текущее время (мкс)
+         * @return PacketRef Кадр или пустой дескриптор
+         */
+        [[nodiscard]] PacketRef retransmission(int64_t now) noexcept;
+
+        /**
+         * @brief Отказаться от начала окна, если старейший кадр исчерпал повторные передачи
+         * @details Завершаются старейший кадр и следующие за ним исчерпанные: выборочно
+         *          подтверждённые - как доставленные (получатель выдаст их при смене эпохи),
+         *          остальные - как потерянные, с данными без заголовка кадра. Оставшиеся кадры
+         *          переходят в новую эпоху: все оформляются DATA_SYNC с новым началом окна,
+         *          первый из них передаётся сразу. Если для этого не хватает ячейки пула,
+         *          отказ откладывается на таймер.
+         * @param now Текущее время (мкс)
+         * @param resolve Callback завершения кадров
+         * @return size_t Количество завершённых кадров
+         */
+        size_t abandon(int64_t now, const ResolveFunction& resolve);
+
+        /**
+         * @brief Время до ближайшего события таймера окна отправки
+         * @param now Текущее время (мкс)
+         * @return int64_t Задержка (мкс) или -1, если таймеры не запущены
+         */
+        [[nodiscard]] int64_t timeoutUs(int64_t now) const noexcept;
+
+        /**
+         * @brief Обработать подтверждение
+         * @param frame Кадр ACK
+         * @param now Текущее время (мкс)
+         * @param resolve Callback завершения подтверждённых кадров (delivered = true)
+         * @return size_t Количество освобождённых кадров
+         */
+        size_t onAck(const Packet& frame, int64_t now, const ResolveFunction& resolve);
+
+        /**
+         * @brief Сглаженное время подтверждения
+         * @return uint32_t SRTT (мкс) или 0, если измерений ещё не было
+         */
+        [[nodiscard]] uint32_t smoothedRttUs() const noexcept;
+
+        // ---- Приём ----
+
+        /**
+         * @brief Обработать кадр данных
+         * @param frame Кадр DATA или DATA_SYNC
+         * @param deliver Callback выдачи данных по порядку (без заголовка)
+         * @return bool false - кадр некорректен
+         */
+        bool onData(const Packet& frame, const std::function<void(const Packet& payload)>& deliver);
+
+        /**
+         * @brief Проверка необходимости отправить подтверждение
+         */
+        [[nodiscard]] bool ackPending() const noexcept { return mAckPending.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Сформировать подтверждение текущего состояния окна приёма
+         * @return PacketRef Кадр ACK или пустой дескриптор (подтверждение не требуется, пул исчерпан);
+         *         при исчерпании пула подтверждение пропускается до следующего кадра данных
+         */
+        [[nodiscard]] PacketRef takeAck() noexcept;
+
+    private:
+        static constexpr size_t DATA_HEADER = 2; ///< Заголовок DATA
+        static constexpr size_t SYNC_HEADER = 4; ///< Заголовок DATA_SYNC
+        static constexpr size_t ACK_SIZE = 5;    ///< Размер ACK
+
+        /**
+         * @brief Кадр окна отправки
+         */
+        struct TxEntry
+        {
+            PacketRef frame;           ///< Кадр
+            int64_t sentAt = 0;        ///< Время последней передачи (мкс)
+            int64_t deadline = 0;      ///< Время повторной передачи (мкс)
+            uint8_t transmissions = 0; ///< Количество передач
+            bool sacked = false;       ///< Выборочно подтверждён
+        };
+
+        /**
+         * @brief Учесть измерение времени подтверждения
+         */
+        void sampleRtt(int64_t rttUs) noexcept;
+
+        /**
+         * @brief Проверка исчерпания повторных передач кадра
+         */
+        [[nodiscard]] bool exhausted(const TxEntry& entry) const noexcept;
+
+        /**
+         * @brief Выдать накопленные кадры приёма с номерами от mExpected до seq (пропуская отсутствующие)
+         * @details Если seq за пределами окна, выдаются все накопленные кадры
+         */
+        void flushBefore(uint8_t seq, const std::function<void(const Packet& payload)>& deliver);
+
+        /**
+         * @brief Сделать ячейку кадра окна отправки неразделяемой (скопировать, если её держит драйвер)
+         * @return bool false - ячейка разделяется, а пул исчерпан
+         */
+        [[nodiscard]] static bool own(PacketRef& frame) noexcept;
+
+        /**
+         * @brief Оформить кадр данных как DATA_SYNC эпохи epoch с началом окна base
+         * @note Ячейка должна быть неразделяемой (own)
+         */
+        static void resync(Packet& frame, uint8_t epoch, uint8_t base) noexcept;
+
+        /**
+         * @brief Скопировать данные кадра без заголовка в ячейку пула
+         */
+        [[nodiscard]] static PacketRef strip(const Packet& frame, size_t header) noexcept;
+
+        /**
+         * @brief Снять заголовок кадра данных (на месте или в копии, если ячейка разделяется)
+         */
+        static void unwrap(PacketRef& frame) noexcept;
+
+        ReliablePolicy mPolicy; ///< Политика
+
+        // Окно отправки
+        std::array<TxEntry, ReliablePolicy::MAX_WINDOW> mTx; ///< Кадры окна (индекс - seq % MAX_WINDOW)
+        uint8_t mBase = 0;                                   ///< Старейший неподтверждённый номер
+        uint8_t mNextSeq = 0;                                ///< Номер следующего кадра
+        uint8_t mEpoch = 0;                                  ///< Эпоха отправителя
+        bool mSync = true;                                   ///< Кадры отправляются как DATA_SYNC
+        int64_t mSrtt = 0;                                   ///< Сглаженное время подтверждения (мкс)
+        int64_t mRttVar = 0;                                 ///< Разброс времени подтверждения (мкс)
+        int64_t mRto = 0;                                    ///< Таймер повторной передачи (мкс)
+        mutable std::mutex mTxMutex;                         ///< Мьютекс окна отправки
+
+        // Окно приёма
+        std::array<PacketRef, ReliablePolicy::MAX_WINDOW> mRx; ///< Принятые вне очереди данные
+        uint8_t mExpected = 0;                                 ///< Следующий ожидаемый номер
+        uint8_t mRxEpoch = 0;                                  ///< Эпоха отправителя
+        bool mRxSynced = false;                                ///< Получен DATA_SYNC
+        uint16_t mPeerId = 0;                                  ///< Packet::id отправителя
+        std::atomic<bool> mAckPending = false;                 ///< Требуется подтверждение
+        mutable std::mutex mRxMutex;                           ///< Мьютекс окна приёма
+    };
+} // namespace net
+
+#endif // NET_RELIABLE_H
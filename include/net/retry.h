@@ -0,0 +1,80 @@
+#ifndef NET_RETRY_H
+#define NET_RETRY_H
+
+#include <cstdint>
+
+namespace net
+{
+    /**
+     * @file retry.h
+     * @brief Политика повторной отправки пакетов после временных ошибок
+     */
+
+    /**
+     * @brief Политика повторной отправки
+     * @details После каждой временной ошибки отправка приостанавливается на время
+     *          baseDelayUs * 2^(попытка - 1), но не более maxDelayUs, со случайным уменьшением
+     *          до jitterPercent процентов. Пакет, исчерпавший maxAttempts попыток, отбрасывается
+     *          с вызовом callback ошибок отправки.
+     */
+    struct RetryPolicy
+    {
+        /**
+         * @brief Куда возвращается пакет для повторной отправки
+         */
+        enum class Mode
+        {
+            IN_PLACE, ///< Пакет повторяется первым, порядок отправки сохраняется
+            REQUEUE   ///< Пакет возвращается в конец очереди своего класса
+        };
+
+        static constexpr uint8_t MAX_ATTEMPTS = 63; ///< Максимальное значение счётчика попыток
+
+        uint8_t maxAttempts = 5;        ///< Количество попыток, включая первую (1 - без повторов)
+        uint32_t baseDelayUs = 20000;   ///< Пауза после первой неудачной попытки (мкс)
+        uint32_t maxDelayUs = 1000000;  ///< Максимальная пауза между попытками (мкс)
+        uint8_t jitterPercent = 25;     ///< Случайное уменьшение паузы (0-100 %)
+        Mode mode = Mode::IN_PLACE;     ///< Место пакета при повторе
+
+        /**
+         * @brief Отправка без повторов: пакет отбрасывается после первой ошибки
+         */
+        [[nodiscard]] static constexpr RetryPolicy none() noexcept
+        {
+            return {.maxAttempts = 1};
+        }
+
+        /**
+         * @brief Повторы с экспоненциальной паузой
+         * @param maxAttempts Количество попыток, включая первую (не более MAX_ATTEMPTS)
+         * @param baseDelayUs Пауза после первой неудачной попытки (мкс)
+         * @param maxDelayUs Максимальная пауза (мкс)
+         * @param mode Место пакета при повторе
+         */
+        [[nodiscard]] static constexpr RetryPolicy exponential(const uint8_t maxAttempts,
+                                                               const uint32_t baseDelayUs,
+                                                               const uint32_t maxDelayUs,
+                                                               const Mode mode = Mode::IN_PLACE) noexcept
+        {
+            return {.maxAttempts = maxAttempts, .baseDelayUs = baseDelayUs, .maxDelayUs = maxDelayUs, .mode = mode};
+        }
+
+        /**
+         * @brief Проверка, остались ли попытки после очередной неудачи
+         * @param attempts Количество выполненных попыток
+         */
+        [[nodiscard]] constexpr bool canRetry(const uint8_t attempts) const noexcept
+        {
+            return attempts < maxAttempts && attempts < MAX_ATTEMPTS;
+        }
+
+        /**
+         * @brief Пауза перед следующей попыткой
+         * @param attempts Количество выполненных попыток (не меньше 1)
+         * @return int64_t Пауза в микросекундах с учётом случайного разброса
+         */
+        [[nodiscard]] int64_t delayUs(uint8_t attempts) const noexcept;
+    };
+} // namespace net
+
+#endif // NET_RETRY_H
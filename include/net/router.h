@@ -0,0 +1,175 @@
+#ifndef NET_ROUTER_H
+#define NET_ROUTER_H
+
+#include "net/transport.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+
+namespace net
+{
+    /**
+     * @file router.h
+     * @brief Пересылка принятых пакетов между транспортами по правилам
+     */
+
+    /**
+     * @brief Правило пересылки
+     * @details Пакет, принятый транспортом source, пересылается в destination, если совпадают
+     *          идентификатор (matchId) и начало данных (prefix). Проверяются все правила
+     *          в порядке добавления, поэтому один пакет может уйти в несколько транспортов.
+     */
+    struct Route
+    {
+        static constexpr size_t MAX_PREFIX = 8; ///< Максимальная длина префикса данных
+
+        Transport* source = nullptr;                      ///< Транспорт-источник
+        Transport* destination = nullptr;                 ///< Транспорт-получатель
+        std::optional<uint16_t> matchId;                  ///< Packet::id принятого пакета (nullopt - любой)
+        std::array<uint8_t, MAX_PREFIX> prefix{};         ///< Начало данных пакета
+        uint8_t prefixSize = 0;                           ///< Длина префикса (0 - любые данные)
+        std::optional<uint16_t> targetId;                 ///< Packet::id пересланного пакета (nullopt - без изменения)
+        Priority priority = Priority::INTERACTIVE;        ///< Класс приоритета в очереди получателя
+        PacingPolicy rateLimit = PacingPolicy::unpaced(); ///< Ограничение скорости пересылки по правилу
+        bool consume = true;                              ///< Не передавать пересланный пакет в callback данных источника
+
+        /**
+         * @brief Правило пересылки всех пакетов источника
+         * @param source Транспорт-источник
+         * @param destination Транспорт-получатель
+         */
+        [[nodiscard]] static Route forward(Transport& source, Transport& destination) noexcept
+        {
+            Route route;
+            route.source = &source;
+            route.destination = &destination;
+            return route;
+        }
+
+        /**
+         * @brief Задать префикс данных
+         * @param bytes Префикс (не длиннее MAX_PREFIX)
+         * @return true если префикс установлен
+         */
+        bool setPrefix(std::span<const uint8_t> bytes) noexcept;
+
+        /**
+         * @brief Проверка совпадения принятого пакета с правилом
+         * @param from Транспорт, принявший пакет
+         * @param packet Пакет
+         */
+        [[nodiscard]] bool matches(const Transport& from, const Packet& packet) const noexcept;
+    };
+
+    /**
+     * @brief Статистика правила пересылки
+     */
+    struct RouteStats
+    {
+        uint32_t forwarded = 0;   ///< Пакетов поставлено в очередь получателя
+        uint32_t bytes = 0;       ///< Байт поставлено в очередь получателя
+        uint32_t rateLimited = 0; ///< Пакетов отброшено ограничением скорости правила
+        uint32_t rejected = 0;    ///< Пакетов не принято получателем (очередь заполнена, пул исчерпан)
+    };
+
+    /**
+     * @brief Маршрутизатор пакетов между транспортами
+     * @details Подключается к транспортам-источникам (attach()) и получает принятые ими пакеты
+     *          после разбора объединения и распаковки. Для каждого подходящего правила пакет
+     *          копируется в ячейку PacketPool и ставится в очередь получателя без дальнейшего
+     *          копирования (send(PacketRef)), поэтому пересылка не проходит через callback данных.
+     *          Ячейка не разделяется между получателями: send() записывает в неё время постановки
+     *          и срок отправки (setPacketTtl()) своего транспорта.
+     *          Ограничение скорости правила отбрасывает лишние пакеты, а не задерживает их;
+     *          скорость отправки получателя по-прежнему задаёт его собственный Pacer.
+     * @note Правила и источники можно менять во время работы. Транспорты должны существовать
+     *       дольше маршрутизатора; деструктор отключает источники и дожидается текущих вызовов.
+     * @warning Не вызывать attach(), detach() и деструктор из callback транспорта-источника
+     */
+    class Router
+    {
+    public:
+        /// @brief Тег для логирования
+        static constexpr auto TAG = "Router";
+
+        static constexpr size_t MAX_ROUTES = 8;  ///< Максимальное количество правил
+        static constexpr size_t MAX_SOURCES = 4; ///< Максимальное количество подключённых источников
+
+        Router() = default;
+        ~Router();
+
+        // Запрет копирования и присваивания
+        Router(const Router&) = delete;
+        Router& operator=(const Router&) = delete;
+
+        /**
+         * @brief Подключить транспорт-источник
+         * @param transport Транспорт; принятые им пакеты проверяются по правилам
+         * @return esp_err_t ESP_OK или ESP_ERR_NO_MEM, если подключено MAX_SOURCES источников
+         */
+        esp_err_t attach(Transport& transport);
+
+        /**
+         * @brief Отключить транспорт-источник
+         * @details После возврата маршрутизатор не получает пакеты источника
+         * @return esp_err_t ESP_OK
+         */
+        esp_err_t detach(Transport& transport);
+
+        /**
+         * @brief Добавить правило пересылки
+         * @param route Правило
+         * @return std::optional<size_t> Номер правила или nullopt, если правило некорректно или таблица заполнена
+         */
+        [[nodiscard]] std::optional<size_t> addRoute(const Route& route);
+
+        /**
+         * @brief Удалить правило пересылки
+         * @param id Номер правила
+         * @return esp_err_t ESP_OK или ESP_ERR_NOT_FOUND
+         */
+        esp_err_t removeRoute(size_t id);
+
+        /**
+         * @brief Получить статистику правила
+         * @param id Номер правила
+         * @return RouteStats Статистика (нулевая для несуществующего правила)
+         */
+        [[nodiscard]] RouteStats getStats(size_t id) const noexcept;
+
+    private:
+        /**
+         * @brief Запись таблицы правил
+         */
+        struct Entry
+        {
+            bool active = false; ///< Правило используется
+            Route route;         ///< Правило
+            Pacer limiter;       ///< Ограничитель скорости правила
+
+            std::atomic<uint32_t> forwarded{};   ///< Пакетов поставлено в очередь
+            std::atomic<uint32_t> bytes{};       ///< Байт поставлено в очередь
+            std::atomic<uint32_t> rateLimited{}; ///< Отброшено ограничением скорости
+            std::atomic<uint32_t> rejected{};    ///< Не принято получателем
+        };
+
+        /**
+         * @brief Переслать принятый пакет по правилам
+         * @param from Транспорт, принявший пакет
+         * @param packet Пакет
+         * @return true если пакет не нужно передавать в callback данных источника
+         */
+        bool route(const Transport& from, const Packet& packet);
+
+        std::array<Entry, MAX_ROUTES> mRoutes;          ///< Таблица правил
+        std::array<Transport*, MAX_SOURCES> mSources{}; ///< Подключённые источники
+        mutable std::mutex mMutex;                      ///< Мьютекс таблицы правил и источников
+    };
+} // namespace net
+
+#endif // NET_ROUTER_H
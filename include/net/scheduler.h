@@ -0,0 +1,101 @@
+#ifndef NET_SCHEDULER_H
+#define NET_SCHEDULER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace net
+{
+    /**
+     * @file scheduler.h
+     * @brief Классы приоритета отправки и планировщик очередей
+     */
+
+    /**
+     * @brief Класс приоритета пакета при отправке
+     * @note Меньшее значение - более высокий приоритет
+     */
+    enum class Priority : uint8_t
+    {
+        CONTROL = 0,     ///< Управляющие сообщения и подтверждения
+        INTERACTIVE = 1, ///< Интерактивный трафик (по умолчанию)
+        BULK = 2         ///< Фоновая передача больших объёмов
+    };
+
+    /// @brief Количество классов приоритета
+    constexpr size_t PRIORITY_COUNT = 3;
+
+    /**
+     * @brief Политика выбора очереди для следующей отправки
+     */
+    struct SchedulingPolicy
+    {
+        /**
+         * @brief Режим планирования
+         */
+        enum class Mode
+        {
+            STRICT,  ///< Всегда обслуживается непустая очередь наивысшего приоритета
+            WEIGHTED ///< Взвешенный циклический обход: класс получает weights[i] отправок за раунд
+        };
+
+        Mode mode = Mode::STRICT;                            ///< Режим планирования
+        std::array<uint8_t, PRIORITY_COUNT> weights{8, 4, 1}; ///< Веса классов (для WEIGHTED)
+
+        /**
+         * @brief Строгий приоритет
+         */
+        [[nodiscard]] static constexpr SchedulingPolicy strict() noexcept
+        {
+            return {};
+        }
+
+        /**
+         * @brief Взвешенное обслуживание
+         * @param control Вес класса CONTROL
+         * @param interactive Вес класса INTERACTIVE
+         * @param bulk Вес класса BULK
+         */
+        [[nodiscard]] static constexpr SchedulingPolicy weighted(const uint8_t control,
+                                                                 const uint8_t interactive,
+                                                                 const uint8_t bulk) noexcept
+        {
+            return {.mode = Mode::WEIGHTED, .weights = {control, interactive, bulk}};
+        }
+    };
+
+    /**
+     * @brief Планировщик очередей отправки по классам приоритета
+     */
+    class PriorityScheduler
+    {
+    public:
+        /**
+         * @brief Установить политику планирования
+         * @param policy Новая политика (кредиты текущего раунда сбрасываются)
+         */
+        void setPolicy(const SchedulingPolicy& policy) noexcept;
+
+        /**
+         * @brief Получить текущую политику планирования
+         */
+        [[nodiscard]] SchedulingPolicy policy() const noexcept;
+
+        /**
+         * @brief Выбрать класс для следующей отправки
+         * @param pending Признаки наличия пакетов в очереди каждого класса
+         * @return std::optional<Priority> Выбранный класс или std::nullopt, если все очереди пусты
+         */
+        [[nodiscard]] std::optional<Priority> next(const std::array<bool, PRIORITY_COUNT>& pending) noexcept;
+
+    private:
+        SchedulingPolicy mPolicy;                          ///< Текущая политика
+        std::array<uint16_t, PRIORITY_COUNT> mCredits{};   ///< Оставшиеся отправки классов в раунде
+        mutable std::mutex mMutex;                         ///< Мьютекс состояния
+    };
+} // namespace net
+
+#endif // NET_SCHEDULER_H
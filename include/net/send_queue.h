@@ -0,0 +1,162 @@
+#ifndef NET_SEND_QUEUE_H
+#define NET_SEND_QUEUE_H
+
+#include "net/packet_pool.h"
+#include "net/lockfree_queue.h"
+
+#include <memory>
+#include <mutex>
+
+namespace net
+{
+    /**
+     * @file send_queue.h
+     * @brief Хранилища очереди отправки транспорта
+     */
+
+    /**
+     * @brief Интерфейс очереди отправки пакетов
+     * @details Все реализации потокобезопасны и сохраняют порядок FIFO
+     */
+    class SendQueue
+    {
+    public:
+        virtual ~SendQueue() = default;
+
+        /**
+         * @brief Проверка успешной инициализации очереди
+         */
+        [[nodiscard]] virtual bool isValid() const noexcept = 0;
+
+        /**
+         * @brief Поместить пакет в конец очереди
+         * @param packet Дескриптор пакета; при успехе владение переходит очереди
+         * @return true - пакет добавлен, false - очередь заполнена
+         */
+        [[nodiscard]] virtual bool push(PacketRef& packet) = 0;
+
+        /**
+         * @brief Извлечь пакет из начала очереди
+         * @return PacketRef Дескриптор пакета или пустой дескриптор, если пакет недоступен
+         */
+        [[nodiscard]] virtual PacketRef pop() = 0;
+
+        /**
+         * @brief Получить количество пакетов в очереди
+         */
+        [[nodiscard]] virtual size_t size() const = 0;
+
+        /**
+         * @brief Удалить все пакеты из очереди
+         * @return size_t Количество удалённых пакетов
+         */
+        virtual size_t clear() = 0;
+    };
+
+    /**
+     * @brief Очередь дескрипторов пакетов пула (без копирования данных)
+     * @details Хранит указатели на ячейки PacketPool; пакет остаётся в пуле, пока ожидает отправки.
+     *          push() и pop() не блокируют: производители из разных задач не ждут друг друга
+     *          и рабочий поток транспорта.
+     */
+    class HandleQueue final : public SendQueue
+    {
+    public:
+        static constexpr size_t MAX_SIZE = 32;     ///< Максимальная глубина очереди
+        static constexpr size_t DEFAULT_SIZE = 16; ///< Глубина очереди по умолчанию
+
+        /**
+         * @brief Конструктор очереди
+         * @param depth Глубина очереди (ограничивается диапазоном 1..MAX_SIZE)
+         * @note Глубина проверяется до захвата позиции, поэтому одновременные push() из разных
+         *       задач могут кратковременно превысить её (но не MAX_SIZE)
+         */
+        explicit HandleQueue(size_t depth = DEFAULT_SIZE) noexcept;
+        ~HandleQueue() override;
+
+        [[nodiscard]] bool isValid() const noexcept override;
+        [[nodiscard]] bool push(PacketRef& packet) override;
+        [[nodiscard]] PacketRef pop() override;
+        [[nodiscard]] size_t size() const override;
+        size_t clear() override;
+
+    private:
+        LockFreeQueue<PacketSlot*, MAX_SIZE> mQueue; ///< Очередь указателей на ячейки
+        const size_t mDepth;                         ///< Глубина очереди
+    };
+
+    /**
+     * @brief Кольцевой буфер записей переменной длины
+     * @details Каждая запись занимает заголовок и только значимые байты пакета,
+     *          поэтому в том же объёме памяти помещается значительно больше коротких пакетов.
+     *          Ячейка пула освобождается сразу при постановке в очередь и выделяется снова при извлечении.
+     */
+    class RecordQueue final : public SendQueue
+    {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 2048; ///< Размер буфера по умолчанию (байт)
+
+        /**
+         * @brief Конструктор очереди записей
+         * @param capacity Размер кольцевого буфера в байтах
+         */
+        explicit RecordQueue(size_t capacity = DEFAULT_CAPACITY);
+        ~RecordQueue() override;
+
+        [[nodiscard]] bool isValid() const noexcept override;
+        [[nodiscard]] bool push(PacketRef& packet) override;
+        [[nodiscard]] PacketRef pop() override;
+        [[nodiscard]] size_t size() const override;
+        size_t clear() override;
+
+        /**
+         * @brief Получить количество занятых байт буфера
+         */
+        [[nodiscard]] size_t usedBytes() const;
+
+        /**
+         * @brief Получить размер буфера в байтах
+         */
+        [[nodiscard]] size_t capacity() const noexcept { return mCapacity; }
+
+    private:
+#pragma pack(push, 1)
+
+        /**
+         * @brief Заголовок записи
+         * @details Счётчик попыток хранится в свободных битах размера
+         */
+        struct RecordHeader
+        {
+            uint16_t id;             ///< Packet::id
+            uint16_t size : 10;      ///< Packet::size
+            uint16_t attempts : 6;   ///< Количество неудачных попыток отправки (с насыщением)
+            uint32_t time;           ///< Время постановки в очередь (для статистики задержки)
+            uint32_t deadline;       ///< Срок отправки (0 - без срока)
+            CompletionId completion; ///< Ячейка завершения асинхронной отправки
+        };
+
+#pragma pack(pop)
+
+        static_assert(MAX_MTU < (1 << 10), "Packet::size не помещается в заголовок записи");
+
+        /**
+         * @brief Скопировать данные в буфер с учётом переноса через конец
+         */
+        void write(size_t offset, const void* data, size_t len) noexcept;
+
+        /**
+         * @brief Скопировать данные из буфера с учётом переноса через конец
+         */
+        void read(size_t offset, void* data, size_t len) const noexcept;
+
+        std::unique_ptr<uint8_t[]> mBuffer; ///< Кольцевой буфер
+        const size_t mCapacity;             ///< Размер буфера (байт)
+        size_t mHead = 0;                   ///< Смещение первой записи
+        size_t mUsed = 0;                   ///< Занято байт
+        size_t mCount = 0;                  ///< Количество записей
+        mutable std::mutex mMutex;          ///< Мьютекс буфера
+    };
+} // namespace net
+
+#endif // NET_SEND_QUEUE_H
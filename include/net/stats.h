@@ -0,0 +1,146 @@
+#ifndef NET_STATS_H
+#define NET_STATS_H
+
+#include <esp_err.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace net
+{
+    /**
+     * @file stats.h
+     * @brief Статистика работы транспорта
+     */
+
+    /**
+     * @brief Причина потери пакета
+     */
+    enum class DropReason : uint8_t
+    {
+        REJECTED = 0,    ///< Отказ при постановке в очередь (очередь заполнена, пул исчерпан, размер)
+        SEND_ERROR,      ///< Постоянная ошибка отправки
+        RETRY_EXHAUSTED, ///< Исчерпаны попытки RetryPolicy
+        MALFORMED,       ///< Принятый пакет не удалось разобрать (объединение, сжатие)
+        EXPIRED,         ///< Истёк срок отправки пакета в очереди
+        RX_OVERFLOW,     ///< Принятый пакет не поместился в очередь приёма (очередь заполнена, пул исчерпан)
+        PEER_OVERFLOW    ///< Очередь отправки адресата заполнена (BLE: очередь соединения или общий лимит)
+    };
+
+    /// @brief Количество причин потери пакета
+    constexpr size_t DROP_REASON_COUNT = 7;
+
+    /**
+     * @brief Снимок статистики транспорта
+     */
+    struct TransportStats
+    {
+        static constexpr size_t LATENCY_BUCKETS = 16;  ///< Количество интервалов гистограммы задержки
+        static constexpr uint32_t LATENCY_BASE_US = 64; ///< Верхняя граница первого интервала (мкс)
+
+        uint32_t packetsSent = 0;     ///< Пакетов передано драйверу
+        uint32_t bytesSent = 0;       ///< Байт передано драйверу
+        uint32_t packetsReceived = 0; ///< Пакетов передано в callback данных
+        uint32_t bytesReceived = 0;   ///< Байт передано в callback данных
+        uint32_t retries = 0;         ///< Повторных попыток отправки
+        uint32_t sendErrors = 0;      ///< Неудачных вызовов отправки драйвера
+        esp_err_t lastError = ESP_OK; ///< Код последней ошибки отправки
+        uint32_t queueHighWater = 0;  ///< Максимальная суммарная длина очередей отправки
+
+        std::array<uint32_t, DROP_REASON_COUNT> drops{}; ///< Потерянные пакеты по причинам (индекс - DropReason)
+
+        /**
+         * @brief Гистограмма задержки от постановки в очередь до передачи драйверу
+         * @details Интервал 0 - меньше LATENCY_BASE_US, интервал i - [LATENCY_BASE_US * 2^(i-1),
+         *          LATENCY_BASE_US * 2^i), последний интервал не ограничен сверху (примерно от 1 с)
+         */
+        std::array<uint32_t, LATENCY_BUCKETS> latency{};
+
+        /**
+         * @brief Количество потерянных пакетов по причине
+         */
+        [[nodiscard]] uint32_t dropped(const DropReason reason) const noexcept
+        {
+            return drops[static_cast<size_t>(reason)];
+        }
+    };
+
+    /**
+     * @brief Счётчики статистики транспорта
+     * @details Обновляются атомарными операциями без упорядочивания из любых задач,
+     *          поэтому могут оставаться включёнными постоянно. Снимок не атомарен целиком:
+     *          счётчики читаются по очереди.
+     */
+    class StatsCollector
+    {
+    public:
+        /**
+         * @brief Учесть пакет, переданный драйверу
+         * @param bytes Размер пакета
+         * @param latencyUs Задержка от постановки в очередь (мкс)
+         */
+        void onSent(size_t bytes, uint32_t latencyUs) noexcept;
+
+        /**
+         * @brief Учесть пакет, переданный в callback данных
+         * @param bytes Размер пакета
+         */
+        void onReceived(size_t bytes) noexcept;
+
+        /**
+         * @brief Учесть неудачную попытку отправки
+         * @param err Код ошибки
+         */
+        void onSendError(esp_err_t err) noexcept;
+
+        /**
+         * @brief Учесть повторную попытку отправки
+         */
+        void onRetry() noexcept;
+
+        /**
+         * @brief Учесть потерю пакета
+         */
+        void onDrop(DropReason reason) noexcept;
+
+        /**
+         * @brief Учесть длину очередей отправки
+         * @param depth Суммарная длина очередей после постановки пакета
+         */
+        void onQueueDepth(size_t depth) noexcept;
+
+        /**
+         * @brief Получить снимок статистики
+         */
+        [[nodiscard]] TransportStats snapshot() const noexcept;
+
+        /**
+         * @brief Обнулить статистику
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Номер интервала гистограммы задержки
+         * @param latencyUs Задержка (мкс)
+         */
+        [[nodiscard]] static size_t latencyBucket(uint32_t latencyUs) noexcept;
+
+    private:
+        using Counter = std::atomic<uint32_t>;
+
+        Counter mPacketsSent{};                                          ///< Пакетов передано драйверу
+        Counter mBytesSent{};                                            ///< Байт передано драйверу
+        Counter mPacketsReceived{};                                      ///< Пакетов передано в callback
+        Counter mBytesReceived{};                                        ///< Байт передано в callback
+        Counter mRetries{};                                              ///< Повторных попыток
+        Counter mSendErrors{};                                           ///< Неудачных попыток отправки
+        std::atomic<esp_err_t> mLastError = ESP_OK;                      ///< Код последней ошибки
+        Counter mQueueHighWater{};                                       ///< Максимальная длина очередей
+        std::array<Counter, DROP_REASON_COUNT> mDrops{};                 ///< Потери по причинам
+        std::array<Counter, TransportStats::LATENCY_BUCKETS> mLatency{}; ///< Гистограмма задержки
+    };
+} // namespace net
+
+#endif // NET_STATS_H
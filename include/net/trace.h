@@ -0,0 +1,102 @@
+#ifndef NET_TRACE_H
+#define NET_TRACE_H
+
+#include <esp_err.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace net
+{
+    /**
+     * @file trace.h
+     * @brief Кольцевой журнал событий жизненного цикла пакетов
+     * @details Журнал выгружается в лог (Transport::dumpTrace()) и преобразуется в формат
+     *          Chrome trace скриптом tools/trace_to_chrome.py
+     */
+
+    /**
+     * @brief Событие жизненного цикла пакета
+     */
+    enum class TraceEvent : uint8_t
+    {
+        ENQUEUE,      ///< Пакет поставлен в очередь отправки
+        DEQUEUE,      ///< Пакет извлечён из очереди (или добавлен в объединённый пакет)
+        SEND_START,   ///< Начало вызова sendImpl()
+        SEND_DONE,    ///< Завершение вызова sendImpl() (status - результат)
+        RX,           ///< Пакет принят транспортом
+        CALLBACK_DONE ///< Возврат из callback данных
+    };
+
+    /**
+     * @brief Имя события для выгрузки журнала
+     */
+    [[nodiscard]] const char* traceEventName(TraceEvent event) noexcept;
+
+    /**
+     * @brief Запись журнала
+     * @details Пакет отправки связывается между событиями по tag - времени постановки в очередь,
+     *          принятый пакет - по времени события RX
+     */
+    struct TraceRecord
+    {
+        uint32_t time;    ///< Время события (мкс, младшие 32 бита esp_timer_get_time())
+        uint32_t tag;     ///< Метка пакета для связи событий
+        uint16_t id;      ///< Packet::id
+        uint16_t size;    ///< Размер пакета
+        TraceEvent event; ///< Событие
+        uint8_t priority; ///< Класс приоритета (для событий отправки)
+        int16_t status;   ///< Код результата (SEND_DONE; ESP_ERR_TIMEOUT для DEQUEUE устаревшего пакета)
+    };
+
+    /**
+     * @brief Кольцевой журнал фиксированного размера
+     * @details Запись не блокирует: позиция выделяется атомарным счётчиком, старые записи
+     *          перезаписываются. Чтение во время записи может вернуть частично обновлённую запись.
+     */
+    class TraceRing
+    {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 256; ///< Количество записей по умолчанию
+
+        /**
+         * @brief Конструктор журнала
+         * @param capacity Количество записей
+         */
+        explicit TraceRing(size_t capacity = DEFAULT_CAPACITY);
+
+        /**
+         * @brief Проверка успешного выделения памяти
+         */
+        [[nodiscard]] bool isValid() const noexcept { return mRecords != nullptr; }
+
+        /**
+         * @brief Добавить запись
+         * @return uint32_t Время события (может использоваться как метка связанных событий)
+         */
+        uint32_t record(TraceEvent event, uint16_t id, uint16_t size, uint32_t tag,
+                        uint8_t priority = 0, esp_err_t status = ESP_OK) noexcept;
+
+        /**
+         * @brief Прочитать журнал от старых записей к новым
+         * @param out Буфер записей
+         * @return size_t Количество прочитанных записей
+         */
+        [[nodiscard]] size_t read(std::span<TraceRecord> out) const noexcept;
+
+        /**
+         * @brief Количество записей журнала
+         */
+        [[nodiscard]] size_t capacity() const noexcept { return mCapacity; }
+
+    private:
+        std::unique_ptr<TraceRecord[]> mRecords; ///< Записи
+        const size_t mCapacity;                  ///< Количество записей
+        std::atomic<uint32_t> mNext = 0;         ///< Номер следующей записи
+    };
+} // namespace net
+
+#endif // NET_TRACE_H
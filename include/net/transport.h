@@ -2,8 +2,28 @@
 #define NET_TRANSPORT_H
 
 #include "net/packet.h"
+#include "net/packet_pool.h"
+#include "net/completion.h"
+#include "net/channel.h"
+#include "net/compression.h"
+#include "net/coalescing.h"
+#include "net/retry.h"
+#include "net/stats.h"
+#include "net/trace.h"
+#include "net/pacer.h"
+#include "net/reliable.h"
+#include "net/scheduler.h"
+#include "net/send_queue.h"
+#include "net/transport_config.h"
 #include "esp32_c3_objects/callback.h"
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -15,12 +35,17 @@ namespace net
     class Transport
     {
     public:
-        static constexpr uint32_t SEND_INTERVAL_US = 20 * 1000; ///< Интервал между отправками (20 мс)
-        static constexpr size_t MAX_QUEUE_SIZE = 16;            ///< Максимальный размер очереди отправки
+        static constexpr uint32_t SEND_INTERVAL_US = 20 * 1000; ///< Интервал между отправками по умолчанию (20 мс)
+        static constexpr size_t MAX_QUEUE_SIZE = HandleQueue::DEFAULT_SIZE; ///< Размер очереди класса по умолчанию
+        static constexpr UBaseType_t EVENT_SET_SIZE = 24;              ///< Суммарная длина источников событий потока
+        static constexpr uint32_t IDLE_WAIT_MS = 1000;                  ///< Максимальное время сна потока без событий
 
         using PacketCallback = esp32_c3::objects::Callback<Packet>;
         using PacketErrorFunction = std::function<void(const Packet& packet, esp_err_t ret)>;
-        using PacketQueue = esp32_c3::objects::BufferedQueue<Packet, MAX_QUEUE_SIZE>;
+        /// @brief Callback уровня очереди отправки (true - достигнут верхний порог, false - очередь опустилась до нижнего)
+        using WatermarkFunction = std::function<void(bool congested)>;
+        /// @brief Обработчик пересылки принятого пакета (true - пакет не передаётся в callback данных)
+        using ForwardFunction = std::function<bool(const Packet& packet)>;
 
         virtual ~Transport();
 
@@ -31,10 +56,37 @@ namespace net
         /**
          * @brief Привязать callback для обработки входящих данных
          * @param dataCallback Уникальный указатель на callback для входящих данных
-         * @param errorCallback Уникальный указатель на callback для ошибок отправки
+         * @param errorCallback Callback окончательного отказа от отправки пакета
+         *                      (постоянная ошибка, исчерпаны попытки RetryPolicy
+         *                      или истёк срок отправки - ESP_ERR_TIMEOUT)
+         * @details Можно вызывать во время работы: callback вызываются под отдельным мьютексом,
+         *          поэтому после возврата прежние callback не выполняются и больше не будут вызваны.
+         * @warning Не вызывать из самих callback
          */
         void bind(std::unique_ptr<PacketCallback> dataCallback, PacketErrorFunction errorCallback = nullptr);
 
+        /**
+         * @brief Установить обработчик пересылки принятых пакетов (используется Router)
+         * @param forwarder Обработчик; вызывается задачей приёма перед callback данных
+         *                  для каждого пакета после разбора объединения и распаковки
+         * @return esp_err_t ESP_OK
+         * @details Можно вызывать во время работы: обработчик вызывается под отдельным мьютексом,
+         *          поэтому после возврата прежний обработчик не выполняется и больше не будет вызван.
+         * @warning Не вызывать из самого обработчика
+         */
+        esp_err_t setForwarder(ForwardFunction forwarder);
+
+        /**
+         * @brief Привязать callback логического канала
+         * @param channel Номер канала (меньше MAX_CHANNELS)
+         * @param callback Callback данных канала (nullptr - пакеты канала получает общий callback данных);
+         *                 ответы callback отправляются в тот же канал
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_ARG
+         * @note Действует только при включённых каналах (setChannelsEnabled()). Можно вызывать
+         *       во время работы, но не из callback транспорта (см. bind())
+         */
+        esp_err_t bindChannel(uint8_t channel, std::unique_ptr<PacketCallback> callback);
+
         /**
          * @brief Запуск/проверка рабочего потока
          * @return true если поток успешно запущен или уже работает
@@ -59,51 +111,432 @@ namespace net
         [[nodiscard]] virtual size_t getMtuSize() const noexcept = 0;
 
         /**
-         * @brief Добавить пакет в очередь отправки (потокобезопасно)
-         * @param packet Пакет для отправки
-         * @return esp_err_t ESP_OK при успешном добавлении в очередь
+         * @brief Добавить пакет в очередь отправки (потокобезопасно, без блокировок)
+         * @param packet Пакет для отправки (копируется в ячейку пула)
+         * @param priority Класс приоритета
+         * @param timeout Максимальное время ожидания свободной ячейки пула и места в очереди
+         *                (0 - не ждать, portMAX_DELAY - без ограничения)
+         * @return esp_err_t ESP_OK при успешном добавлении в очередь,
+         *         ESP_ERR_NO_MEM если пул пакетов исчерпан,
+         *         ESP_ERR_INVALID_STATE если очередь класса заполнена
+         * @warning Не вызывать с ненулевым таймаутом из callback транспорта: место освобождает
+         *          рабочий поток, который в это время ждёт возврата из callback
+         */
+        esp_err_t send(const Packet& packet, Priority priority = Priority::INTERACTIVE, TickType_t timeout = 0);
+
+        /**
+         * @brief Добавить пакет из пула в очередь отправки без копирования (потокобезопасно, без блокировок)
+         * @details Мьютекс транспорта не захватывается, поэтому вызов не ждёт обработку событий
+         *          драйвера и чтение; с HandleQueue постановка в очередь не блокирует задачу
+         * @param packet Дескриптор пакета из PacketPool
+         * @param priority Класс приоритета
+         * @param timeout Максимальное время ожидания места в очереди (0 - не ждать, portMAX_DELAY - без ограничения)
+         * @return esp_err_t ESP_OK при успешном добавлении в очередь,
+         *         ESP_ERR_INVALID_SIZE если пакет не помещается в MTU после добавления байта формата сжатия
+         *         или заголовка записи объединённого пакета,
+         *         ESP_ERR_INVALID_STATE если очередь класса осталась заполненной
+         * @note При включённом сжатии в очередь ставится сжатая копия в новой ячейке пула
+         * @warning Не вызывать с ненулевым таймаутом из callback транспорта (см. send(const Packet&))
+         */
+        esp_err_t send(PacketRef packet, Priority priority = Priority::INTERACTIVE, TickType_t timeout = 0);
+
+        /**
+         * @brief Добавить пакет в очередь отправки с уведомлением о завершении (потокобезопасно)
+         * @details Результат фиксируется один раз (см. completion.h): ESP_OK после передачи драйверу
+         *          (для BLE - после приёма очередью соединения, а не подтверждения клиентом),
+         *          ошибка постановки в очередь или отправки, ESP_ERR_TIMEOUT при истечении срока
+         *          (setPacketTtl()), ESP_ERR_INVALID_STATE при удалении пакета без отправки.
+         *          Пакет объединения завершается вместе с объединённым пакетом.
+         * @param packet Пакет для отправки (копируется в ячейку пула)
+         * @param onComplete Callback завершения (может быть пустым); вызывается из задачи,
+         *                   завершившей отправку, - обычно рабочего потока, поэтому не должен блокировать
+         * @param priority Класс приоритета
+         * @return SendHandle Дескриптор ожидания; при исчерпании CompletionPool - завершённый с ESP_ERR_NO_MEM
          */
-        esp_err_t send(const Packet& packet);
+        [[nodiscard]] SendHandle sendAsync(const Packet& packet, CompletionFunction onComplete = nullptr,
+                                           Priority priority = Priority::INTERACTIVE);
 
         /**
          * @brief Получить текущий размер очереди отправки
-         * @return size_t Количество пакетов в очереди
+         * @return size_t Количество пакетов во всех классах приоритета
          */
         [[nodiscard]] size_t getQueueSize() const;
 
+        /**
+         * @brief Получить размер очереди отправки класса
+         * @param priority Класс приоритета
+         * @return size_t Количество пакетов в очереди класса
+         */
+        [[nodiscard]] size_t getQueueSize(Priority priority) const;
+
         /**
          * @brief Очистить очередь отправки
          * @return size_t Количество удалённых пакетов
          */
         size_t clearQueue();
 
+        /**
+         * @brief Заменить хранилище очереди отправки класса
+         * @param queue Новая очередь (например, RecordQueue для коротких пакетов)
+         * @param priority Класс приоритета
+         * @return esp_err_t ESP_OK при успешной замене,
+         *         ESP_ERR_INVALID_ARG если очередь не инициализирована,
+         *         ESP_ERR_INVALID_STATE если рабочий поток уже запущен
+         * @note Допускается только до вызова start()
+         */
+        esp_err_t setSendQueue(std::unique_ptr<SendQueue> queue, Priority priority = Priority::INTERACTIVE);
+
+        /**
+         * @brief Установить политику обслуживания классов приоритета
+         * @param policy Строгий приоритет или взвешенное обслуживание
+         */
+        void setScheduling(const SchedulingPolicy& policy) noexcept;
+
+        /**
+         * @brief Получить текущую политику обслуживания классов приоритета
+         */
+        [[nodiscard]] SchedulingPolicy getScheduling() const noexcept;
+
+        /**
+         * @brief Установить политику ограничения скорости отправки
+         * @param policy Политика (token bucket по пакетам/байтам или PacingPolicy::unpaced())
+         * @note Может вызываться во время работы; по умолчанию один пакет за SEND_INTERVAL_US
+         */
+        void setPacing(const PacingPolicy& policy) noexcept;
+
+        /**
+         * @brief Получить текущую политику ограничения скорости отправки
+         */
+        [[nodiscard]] PacingPolicy getPacing() const noexcept;
+
+        /**
+         * @brief Установить сжатие полезной нагрузки канала
+         * @param compression Режим сжатия; должен совпадать на обеих сторонах канала
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_STATE, если рабочий поток уже запущен
+         * @note При сжатии каждый пакет получает байт формата, поэтому несжимаемый пакет
+         *       не может превышать MAX_MTU - COMPRESSION_OVERHEAD байт
+         */
+        esp_err_t setCompression(Compression compression);
+
+        /**
+         * @brief Получить режим сжатия полезной нагрузки
+         */
+        [[nodiscard]] Compression getCompression() const;
+
+        /**
+         * @brief Включить логические каналы
+         * @param enabled true - первый байт данных каждого пакета является номером канала;
+         *                режим должен совпадать на обеих сторонах
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_STATE, если рабочий поток уже запущен
+         * @details Принятый пакет передаётся в callback своего канала (bindChannel()) без заголовка;
+         *          пакеты каналов без callback получает общий callback данных. Обработчик пересылки
+         *          (Router) получает пакеты вместе с заголовком, поэтому правила по префиксу из одного
+         *          байта выбирают канал, а пересланный пакет сохраняет его.
+         */
+        esp_err_t setChannelsEnabled(bool enabled);
+
+        /**
+         * @brief Проверка включения логических каналов
+         */
+        [[nodiscard]] bool channelsEnabled() const;
+
+        /**
+         * @brief Установить класс приоритета канала для sendChannel()
+         * @param channel Номер канала (меньше MAX_CHANNELS)
+         * @param priority Класс приоритета (очередь отправки канала)
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_ARG
+         */
+        esp_err_t setChannelPriority(uint8_t channel, Priority priority) noexcept;
+
+        /**
+         * @brief Добавить пакет логического канала в очередь отправки
+         * @param channel Номер канала (меньше MAX_CHANNELS)
+         * @param packet Пакет (копируется в ячейку пула вместе с заголовком канала)
+         * @param timeout Максимальное время ожидания места (см. send(const Packet&))
+         * @return esp_err_t Результат send() или ESP_ERR_INVALID_ARG для неверного канала,
+         *         ESP_ERR_INVALID_SIZE если пакет не помещается в MAX_MTU вместе с заголовком,
+         *         ESP_ERR_INVALID_STATE если каналы выключены
+         */
+        esp_err_t sendChannel(uint8_t channel, const Packet& packet, TickType_t timeout = 0);
+
+        /**
+         * @brief Получить статистику логического канала
+         * @param channel Номер канала
+         */
+        [[nodiscard]] ChannelStats getChannelStats(uint8_t channel) const noexcept;
+
+        /**
+         * @brief Установить политику объединения коротких пакетов
+         * @param policy Политика; должна быть включена на обеих сторонах канала
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_STATE, если рабочий поток уже запущен
+         * @details Пакеты одного адресата и класса приоритета собираются в один пакет размером
+         *          до getMtuSize() и отправляются за один интервал ограничителя скорости.
+         *          Callback ошибок отправки получает объединённый пакет.
+         * @note Каждый пакет получает заголовок записи, поэтому пакет длиннее MAX_MTU - 2 байт
+         *       не может быть отправлен
+         */
+        esp_err_t setCoalescing(const CoalescingPolicy& policy);
+
+        /**
+         * @brief Получить политику объединения коротких пакетов
+         */
+        [[nodiscard]] CoalescingPolicy getCoalescing() const;
+
+        /**
+         * @brief Установить политику надёжной доставки
+         * @param policy Политика; должна быть включена на обеих сторонах канала
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_STATE, если рабочий поток уже запущен
+         * @details Каждый пакет (объединённый пакет при включённом объединении) отправляется кадром
+         *          с номером и хранится в окне до подтверждения получателем; потерянные кадры
+         *          передаются повторно по таймеру, принятые кадры выдаются в callback данных по порядку
+         *          без повторов. Подтверждения отправляются рабочим потоком вне очередей отправки.
+         *          Асинхронная отправка завершается с ESP_OK после подтверждения (callback вызывается
+         *          задачей приёма) или с ESP_ERR_TIMEOUT после исчерпания повторных передач.
+         *          RetryPolicy не применяется: кадр, не принятый драйвером, остаётся в окне.
+         * @note Сессия одна на транспорт: режим рассчитан на соединение точка-точка (UART, USB-JTAG,
+         *       одно соединение BLE). Кадр добавляет до ReliableSession::MAX_OVERHEAD байт.
+         *       Пакеты объединения завершаются при передаче объединённого пакета в окно.
+         */
+        esp_err_t setReliable(const ReliablePolicy& policy);
+
+        /**
+         * @brief Получить политику надёжной доставки
+         */
+        [[nodiscard]] ReliablePolicy getReliable() const;
+
+        /**
+         * @brief Получить сглаженное время подтверждения кадров
+         * @return uint32_t Время (мкс) или 0, если надёжная доставка не использовалась
+         */
+        [[nodiscard]] uint32_t getRttUs() const noexcept;
+
+        /**
+         * @brief Установить политику повторной отправки после временных ошибок
+         * @param policy Политика (количество попыток, пауза, разброс, место пакета при повторе)
+         * @note Может вызываться во время работы; объединённые пакеты всегда повторяются на месте
+         */
+        void setRetry(const RetryPolicy& policy);
+
+        /**
+         * @brief Получить политику повторной отправки
+         */
+        [[nodiscard]] RetryPolicy getRetry() const;
+
+        /**
+         * @brief Установить срок жизни пакетов в очереди отправки
+         * @details Пакет, не переданный драйверу до истечения срока, удаляется из очереди без отправки:
+         *          учитывается в статистике (DropReason::EXPIRED), передаётся в callback ошибок
+         *          и завершает асинхронную отправку с ESP_ERR_TIMEOUT
+         * @param ttlUs Срок жизни от постановки в очередь (мкс, 0 - без ограничения, не более 35 минут)
+         * @note Применяется к пакетам без собственного срока (PacketRef::setDeadline()).
+         *       Срок проверяется при извлечении из очереди: собранный объединённый пакет
+         *       и пакет, повторяемый в составе объединённого, отправляются независимо от срока.
+         */
+        void setPacketTtl(uint32_t ttlUs) noexcept;
+
+        /**
+         * @brief Установить пороги уведомлений о заполнении очереди отправки
+         * @details Уровень - суммарная длина очередей всех классов. Callback получает true,
+         *          когда после постановки пакета уровень достигает high, и false, когда
+         *          после извлечения или очистки уровень опускается до low (с гистерезисом,
+         *          по одному уведомлению на переход).
+         * @param high Верхний порог (0 - уведомления выключены)
+         * @param low Нижний порог (меньше high)
+         * @param callback Callback уровня; true вызывается из задачи-отправителя, false - из рабочего потока
+         * @return esp_err_t ESP_OK, ESP_ERR_INVALID_ARG при low >= high
+         *         или ESP_ERR_INVALID_STATE, если рабочий поток уже запущен
+         */
+        esp_err_t setQueueWatermarks(size_t high, size_t low, WatermarkFunction callback);
+
+        /**
+         * @brief Проверка превышения верхнего порога очереди отправки
+         * @return true после уведомления о верхнем пороге до уведомления о нижнем
+         */
+        [[nodiscard]] bool isCongested() const noexcept;
+
+        /**
+         * @brief Получить срок жизни пакетов в очереди отправки
+         * @return uint32_t Срок жизни (мкс, 0 - без ограничения)
+         */
+        [[nodiscard]] uint32_t getPacketTtl() const noexcept;
+
+        /**
+         * @brief Получить снимок статистики транспорта
+         * @note Отправленным считается пакет, принятый драйвером (для BLE - очередью соединения)
+         */
+        [[nodiscard]] TransportStats getStats() const noexcept;
+
+        /**
+         * @brief Обнулить статистику транспорта и логических каналов
+         */
+        void resetStats() noexcept;
+
+        /**
+         * @brief Минимальный запас стека рабочего потока за время работы
+         * @return size_t Запас стека (байт) или 0, если поток не запущен
+         * @note Помогает подобрать TransportConfig::stackSize
+         */
+        [[nodiscard]] size_t getStackHighWaterMark() const noexcept;
+
+        /**
+         * @brief Включить журнал событий жизненного цикла пакетов
+         * @param capacity Количество записей (0 - выключить журнал)
+         * @return esp_err_t ESP_OK, ESP_ERR_NO_MEM при нехватке памяти
+         *         или ESP_ERR_INVALID_STATE, если рабочий поток уже запущен
+         * @note По умолчанию журнал выключен и не расходует ни память, ни время
+         */
+        esp_err_t enableTrace(size_t capacity = TraceRing::DEFAULT_CAPACITY);
+
+        /**
+         * @brief Прочитать журнал событий от старых записей к новым
+         * @param out Буфер записей
+         * @return size_t Количество прочитанных записей (0, если журнал выключен)
+         */
+        [[nodiscard]] size_t readTrace(std::span<TraceRecord> out) const noexcept;
+
+        /**
+         * @brief Вывести журнал событий в лог (ESP_LOGI, по строке на запись)
+         * @note Вывод преобразуется в формат Chrome trace скриптом tools/trace_to_chrome.py
+         */
+        void dumpTrace() const;
+
     protected:
-        explicit Transport(const char* tag);
+        /**
+         * @brief Конструктор транспорта
+         * @param tag Тег для логирования
+         * @param config Параметры рабочего потока и очередей
+         */
+        explicit Transport(const char* tag, const TransportConfig& config = {});
 
         /**
          * @brief Внутренняя реализация отправки пакета
-         * @param packet Пакет для отправки
-         * @return esp_err_t Результат отправки
+         * @param packet Дескриптор пакета для отправки
+         * @param priority Класс приоритета пакета (для транспортов с собственными очередями)
+         * @return esp_err_t Результат отправки: ESP_ERR_NO_MEM, ESP_ERR_INVALID_STATE, ESP_ERR_TIMEOUT -
+         *         временная ошибка драйвера (повтор по RetryPolicy с паузой всей отправки),
+         *         ESP_ERR_NOT_FINISHED - очередь адресата заполнена (пакет отбрасывается без паузы,
+         *         DropReason::PEER_OVERFLOW), остальные - постоянная ошибка
          * @note Должна быть переопределена в наследниках
          */
-        [[nodiscard]] virtual esp_err_t sendImpl(Packet& packet) = 0;
+        [[nodiscard]] virtual esp_err_t sendImpl(const PacketRef& packet, Priority priority) = 0;
 
         /**
          * @brief Обработать очередь отправки
-         * @note Отправляет не чаще чем раз в SEND_INTERVAL_US
+         * @note Отправляет не чаще, чем позволяет текущая политика PacingPolicy
          */
         void processSendQueue();
 
         /**
-         * @brief Обрабатывает ошибки отправки пакета согласно стратегии восстановления
+         * @brief Ожидание событий рабочим потоком
+         * @details Поток спит до постановки пакета в очередь, поступления данных
+         *          от источника событий или наступления времени следующей отправки
+         * @return QueueSetMemberHandle_t Источник событий с данными (nullptr - таймаут или пробуждение)
+         */
+        [[nodiscard]] QueueSetMemberHandle_t waitForEvents();
+
+        /**
+         * @brief Время до следующей возможной отправки
+         * @param now Текущее время (мкс)
+         * @return int64_t Задержка в микросекундах (0 - можно отправлять сейчас)
+         */
+        [[nodiscard]] int64_t sendDelayUs(int64_t now) noexcept;
+
+        /**
+         * @brief Разбудить рабочий поток
+         */
+        void notifyWorker() const noexcept;
+
+        /**
+         * @brief Добавить очередь драйвера в набор источников событий рабочего потока
+         * @param queue Очередь событий (например, очередь событий UART)
+         * @return bool true при успешном добавлении
+         * @note Длина очереди учитывается в EVENT_SET_SIZE; очередь должна быть пустой
+         */
+        bool addEventSource(QueueHandle_t queue) const noexcept;
+
+        /**
+         * @brief Удалить очередь драйвера из набора источников событий
+         * @param queue Ранее добавленная очередь событий
          */
-        void handleSendError(const Packet& packet, esp_err_t err);
+        void removeEventSource(QueueHandle_t queue) const noexcept;
+
+        /**
+         * @brief Интервал опроса приёма для транспортов без очереди событий
+         * @return TickType_t Максимальное время ожидания событий (portMAX_DELAY - без опроса)
+         */
+        [[nodiscard]] virtual TickType_t receivePollInterval() const noexcept { return portMAX_DELAY; }
+
+        /**
+         * @brief Обрабатывает ошибки отправки пакета согласно политике RetryPolicy
+         * @details Временная ошибка приостанавливает отправку на паузу политики и возвращает пакет
+         *          на место или в конец очереди; постоянная ошибка или исчерпание попыток
+         *          отбрасывает пакет с вызовом callback ошибок. Заполненная очередь адресата
+         *          (ESP_ERR_NOT_FINISHED) отбрасывает пакет без паузы: другие адресаты не ждут
+         * @param packet Пакет, отправка которого не удалась
+         * @param err Код ошибки
+         * @param priority Класс приоритета, в очередь которого возвращается пакет
+         */
+        void handleSendError(PacketRef packet, esp_err_t err, Priority priority);
+
+        /**
+         * @brief Вызвать callback ошибок отправки, если он привязан
+         * @param packet Пакет, от отправки которого транспорт отказался
+         * @param err Код ошибки
+         */
+        void reportError(const Packet& packet, esp_err_t err);
+
+        /**
+         * @brief Резерв ячеек пула пакетов транспорта (для ячеек, выделяемых драйвером)
+         */
+        [[nodiscard]] PacketPool::ReservationId poolReservation() const noexcept { return mPoolReservation; }
+
+        /**
+         * @brief Отложенная передача на стороне транспорта (например, очереди соединений BLE)
+         * @return int64_t Через сколько микросекунд требуется повторный вызов (-1 - нет отложенных данных)
+         * @note Вызывается рабочим потоком после обработки очереди отправки и не должна блокировать
+         */
+        [[nodiscard]] virtual int64_t processTransmit() { return -1; }
 
         /**
          * @brief Обработка входящих данных (для транспортов с непрерывным потоком)
-         * @note Для BLE не используется (обработка через callback)
+         * @param source Источник событий, выбранный waitForEvents() (nullptr - таймаут или пробуждение);
+         *               читать можно только из него, иначе в наборе останутся лишние уведомления
+         * @note Вызывается после каждого пробуждения рабочего потока и не должна блокировать.
+         *       BLE передаёт здесь пакеты из очереди приёма, заполняемой задачей стека Bluetooth
+         */
+        virtual void processReceivedData(QueueSetMemberHandle_t source) {};
+
+        /**
+         * @brief Передать принятый пакет в callback данных
+         * @param packet Принятый пакет (при включённом объединении разбирается на исходные пакеты,
+         *               при включённом сжатии распаковывается); ответы callback ставятся в очередь отправки
+         */
+        void dispatchReceived(const Packet& packet);
+
+        /**
+         * @brief Проверка наличия получателя принятых пакетов (callback данных, пересылка
+         *        или надёжная доставка, которой нужны подтверждения)
+         * @note Транспорт без получателя может не читать входящие данные
+         */
+        [[nodiscard]] bool hasReceiver() const noexcept;
+
+        /**
+         * @brief Записать событие в журнал, если он включён
+         * @param event Событие
+         * @param packet Пакет
+         * @param tag Метка для связи событий пакета
+         * @param priority Класс приоритета
+         * @param status Код результата
+         * @return uint32_t Время события (0, если журнал выключен)
          */
-        virtual void processReceivedData() {};
+        uint32_t trace(TraceEvent event, const Packet& packet, uint32_t tag,
+                       Priority priority = Priority::INTERACTIVE, esp_err_t status = ESP_OK) const noexcept;
+
+        /**
+         * @brief Проверка, является ли ошибка временной
+         * @return true если ошибка допускает повторную отправку
+         */
+        [[nodiscard]] static bool isTemporary(esp_err_t ret) noexcept;
 
         /**
          * @brief Устанавливает флаг инициализации транспорта
@@ -111,24 +544,141 @@ namespace net
          */
         void setInitialized(bool value);
 
-        mutable std::recursive_mutex mMutex; ///< Мьютекс для потокобезопасности
+        mutable std::recursive_mutex mMutex; ///< Мьютекс настроек и состояния драйвера (не используется при отправке)
         esp32_c3::objects::Thread mThread;   ///< Поток обработки
 
         std::unique_ptr<PacketCallback> mDataCallback; ///< Callback для данных
         PacketErrorFunction mErrorCallback;            ///< Callback для ошибок отправки
-        PacketQueue mSendQueue;                        ///< Очередь пакетов на отправку
+        std::array<std::unique_ptr<PacketCallback>, MAX_CHANNELS> mChannelCallbacks; ///< Callback логических каналов
+        mutable std::mutex mCallbackMutex; ///< Мьютекс callback данных, ошибок и каналов (удерживается на время вызова)
+        ForwardFunction mForwarder;                    ///< Обработчик пересылки принятых пакетов
+        mutable std::mutex mForwarderMutex;            ///< Мьютекс обработчика пересылки (удерживается на время вызова)
+        std::array<std::unique_ptr<SendQueue>, PRIORITY_COUNT> mSendQueues;          ///< Очереди отправки по классам
+        PriorityScheduler mScheduler;                                                ///< Планировщик классов
 
-        uint64_t mNextSendTime = 0; ///< Время следующей отправки (мкс)
+        Pacer mPacer;                         ///< Ограничитель скорости отправки
+        StatsCollector mStats;                ///< Статистика транспорта
+        RetryPolicy mRetry;                   ///< Политика повторной отправки
+        int64_t mRetryTime = 0;               ///< Время, раньше которого не повторять отправку после ошибки (мкс)
+        std::atomic<uint32_t> mPacketTtl = 0; ///< Срок жизни пакетов в очереди (мкс, 0 - без ограничения)
+        int64_t mTransmitDelay = -1;          ///< Задержка до повторного вызова processTransmit() (мкс, -1 - не требуется)
+
+        std::unique_ptr<TraceRing> mTrace; ///< Журнал событий (nullptr - выключен)
+
+        SemaphoreHandle_t mWakeSignal = nullptr;  ///< Сигнал пробуждения рабочего потока
+        SemaphoreHandle_t mSpaceSignal = nullptr; ///< Сигнал освобождения места для ожидающих send()
+        QueueSetHandle_t mEventSet = nullptr;     ///< Набор источников событий рабочего потока
 
     private:
+        /// @brief Максимум ожидающих завершения пакетов в одном объединённом пакете
+        static constexpr size_t MAX_BATCH_COMPLETIONS = 8;
+
         /**
-         * @brief Проверка, является ли ошибка временной
-         * @return true если ошибка допускает повторную отправку
+         * @brief Получить очередь класса приоритета
          */
-        [[nodiscard]] static bool isTemporary(esp_err_t ret) noexcept;
+        [[nodiscard]] SendQueue& queue(Priority priority) const noexcept;
+
+        /**
+         * @brief Извлечь следующий пакет по политике планировщика
+         * @details Пакеты с истёкшим сроком отбрасываются, не расходуя ограничитель скорости
+         * @param priority Класс приоритета извлечённого пакета
+         * @return PacketRef Пакет или пустой дескриптор, если очереди пусты
+         */
+        [[nodiscard]] PacketRef nextPacket(Priority& priority);
+
+        /**
+         * @brief Собрать следующий объединённый пакет
+         * @param priority Класс приоритета объединённого пакета
+         * @return PacketRef Пакет, готовый к отправке, или пустой дескриптор,
+         *         если очереди пусты либо пакет ещё ожидает попутные пакеты
+         */
+        [[nodiscard]] PacketRef nextBatch(Priority& priority);
+
+        /**
+         * @brief Разобрать данные принятого пакета (после снятия кадра надёжной доставки)
+         * @param packet Пакет
+         * @param rxTag Метка события RX в журнале
+         */
+        void dispatchPayload(const Packet& packet, uint32_t rxTag);
+
+        /**
+         * @brief Отправить подтверждение и отказаться от кадров, исчерпавших повторные передачи
+         * @param now Текущее время (мкс)
+         */
+        void processReliable(int64_t now);
+
+        /**
+         * @brief Извлечь следующий пакет и поместить его в окно надёжной доставки
+         * @param priority Класс приоритета пакета
+         * @param now Текущее время (мкс)
+         * @return PacketRef Кадр для отправки или пустой дескриптор
+         */
+        [[nodiscard]] PacketRef nextReliable(Priority& priority, int64_t now);
+
+        /**
+         * @brief Передать исходный пакет в callback данных после распаковки
+         * @param packet Пакет
+         * @param rxTag Метка события RX в журнале
+         */
+        void deliver(const Packet& packet, uint32_t rxTag);
+
+        /**
+         * @brief Завершить асинхронную отправку пакета, если она ожидается
+         * @param packet Пакет
+         * @param result Результат отправки
+         */
+        static void complete(const PacketRef& packet, esp_err_t result) noexcept;
+
+        /**
+         * @brief Завершить асинхронные отправки пакетов, вошедших в объединённый пакет
+         * @param result Результат отправки
+         */
+        void completeBatch(esp_err_t result) noexcept;
+
+        /**
+         * @brief Ожидать освобождения места в очереди или пуле
+         * @param start Время начала ожидания (тики)
+         * @param timeout Максимальное время ожидания от start
+         * @return true если место могло освободиться и стоит повторить попытку
+         */
+        bool waitForSpace(TickType_t start, TickType_t timeout) const noexcept;
+
+        /**
+         * @brief Сообщить об освобождении места: разбудить ожидающие send() и проверить нижний порог
+         */
+        void onQueueSpace();
+
+        const char* mTag;                                ///< Тег для логирования
+        std::atomic<bool> mIsInitialized = false;        ///< Флаг инициализации
+        std::atomic<TaskHandle_t> mWorkerTask = nullptr; ///< Задача рабочего потока (nullptr - не запущен)
+        Compression mCompression = Compression::NONE;    ///< Сжатие полезной нагрузки
+        CoalescingPolicy mCoalescing;                    ///< Политика объединения пакетов
+        bool mChannelsEnabled = false;                   ///< Логические каналы включены
+        ChannelTable mChannels;                          ///< Классы приоритета и статистика каналов
+        bool mReliableEnabled = false;                   ///< Надёжная доставка включена
+        ReliableSession mReliable;                       ///< Окна надёжной доставки
+        PacketPool::ReservationId mPoolReservation = 0;  ///< Резерв ячеек пула пакетов транспорта
+
+        size_t mHighWatermark = 0;            ///< Верхний порог очереди отправки (0 - выключен)
+        size_t mLowWatermark = 0;             ///< Нижний порог очереди отправки
+        WatermarkFunction mWatermarkCallback; ///< Callback уровня очереди отправки
+        std::atomic<bool> mCongested = false; ///< Достигнут верхний порог
+
+        // Состояние объединения, используется только рабочим потоком
+        PacketRef mBatch;                                ///< Собираемый объединённый пакет
+        Priority mBatchPriority = Priority::INTERACTIVE; ///< Класс приоритета собираемого пакета
+        int64_t mBatchDeadline = 0;                      ///< Время отправки собираемого пакета (мкс)
+        PacketRef mCarry;                                ///< Извлечённый пакет, не вошедший в собираемый
+        Priority mCarryPriority = Priority::INTERACTIVE; ///< Класс приоритета извлечённого пакета
+        std::array<CompletionId, MAX_BATCH_COMPLETIONS> mBatchCompletions{}; ///< Ячейки завершения вошедших пакетов
+        size_t mBatchCompletionCount = 0;                                    ///< Количество ячеек завершения
+
+        // Буферы разбора принятых пакетов, используются только рабочим потоком (не занимают его стек)
+        Packet mRxRecord; ///< Запись объединённого пакета
+        Packet mRxPlain;  ///< Распакованный пакет или данные канала без заголовка
 
-        const char* mTag;            ///< Тег для логирования
-        bool mIsInitialized = false; ///< Флаг инициализации
+        PacketRef mRetryPacket;                          ///< Пакет для повтора на месте, используется рабочим потоком
+        Priority mRetryPriority = Priority::INTERACTIVE; ///< Класс приоритета пакета для повтора
     };
 } // namespace net
 
@@ -0,0 +1,36 @@
+#ifndef NET_TRANSPORT_CONFIG_H
+#define NET_TRANSPORT_CONFIG_H
+
+#include "net/pacer.h"
+#include "net/send_queue.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace net
+{
+    /**
+     * @brief Параметры рабочего потока и очередей транспорта
+     * @details Передаётся в конструктор транспорта. Параметры потока применяются при start(),
+     *          поэтому один транспорт можно поднять с высоким приоритетом и глубокой очередью,
+     *          а другой - с уменьшенным стеком.
+     */
+    struct TransportConfig
+    {
+        static constexpr uint32_t DEFAULT_STACK_SIZE = 4096; ///< Размер стека рабочего потока по умолчанию (байт)
+        static constexpr uint8_t DEFAULT_PRIORITY = 19;      ///< Приоритет рабочего потока по умолчанию
+        static constexpr size_t DEFAULT_RX_QUEUE_DEPTH = 8;  ///< Глубина очереди приёма по умолчанию
+        static constexpr size_t DEFAULT_POOL_RESERVE = 4;    ///< Резерв ячеек пула пакетов по умолчанию
+
+        const char* threadName = "TRANSPORT";          ///< Имя задачи (строка должна существовать всё время работы транспорта)
+        uint32_t stackSize = DEFAULT_STACK_SIZE;       ///< Размер стека рабочего потока (байт)
+        uint8_t priority = DEFAULT_PRIORITY;           ///< Приоритет рабочего потока FreeRTOS
+        size_t queueDepth = HandleQueue::DEFAULT_SIZE; ///< Глубина очереди каждого класса (1..HandleQueue::MAX_SIZE)
+        size_t rxQueueDepth = DEFAULT_RX_QUEUE_DEPTH;  ///< Глубина очереди приёма для транспортов, принимающих в чужой задаче (BLE)
+        size_t poolReserve = DEFAULT_POOL_RESERVE;     ///< Ячейки пула пакетов, гарантированные транспорту (0 - только общая часть)
+        std::optional<PacingPolicy> pacing;            ///< Ограничение скорости (nullopt - по умолчанию для транспорта)
+    };
+} // namespace net
+
+#endif // NET_TRANSPORT_CONFIG_H
@@ -2,10 +2,13 @@
 #define NET_UART_H
 
 #include "transport.h"
+#include "framing.h"
 
 #include <driver/gpio.h>
 #include <driver/uart.h>
 
+#include <array>
+
 namespace net
 {
     /**
@@ -48,17 +51,23 @@ namespace net
         /// @brief Тег для логирования
         static constexpr auto TAG = "Uart";
 
+        /// @brief Длина очереди событий драйвера UART
+        static constexpr int EVENT_QUEUE_SIZE = 16;
+        static_assert(EVENT_QUEUE_SIZE <= EVENT_SET_SIZE, "UART event queue exceeds worker event set");
+
         /**
          * @brief Конструктор UART
          * @param type Тип последовательного порта
          * @param config Конфигурация UART (по умолчанию UART_DEFAULT_CONFIG)
          * @param rxPin Пин RX (опционально)
          * @param txPin Пин TX (опционально)
+         * @param transportConfig Параметры рабочего потока и очередей (скорость линии, если pacing не задан)
          */
         explicit Uart(SerialType type,
                       const uart_config_t& config = UART_DEFAULT_CONFIG,
                       std::optional<gpio_num_t> rxPin = std::nullopt,
-                      std::optional<gpio_num_t> txPin = std::nullopt) noexcept;
+                      std::optional<gpio_num_t> txPin = std::nullopt,
+                      const TransportConfig& transportConfig = {}) noexcept;
         ~Uart() override;
 
         // Запрещаем копирование и перемещение
@@ -95,10 +104,12 @@ namespace net
         /**
          * @brief Прочитать данные в предоставленный буфер
          * @param buffer Буфер для чтения данных (диапазон uint8_t)
+         * @param timeout Максимальное время ожидания данных
          * @return Количество фактически прочитанных байт
          * @note Если буфер пуст или UART не инициализирован, вернёт 0
          */
-        [[nodiscard]] size_t read(std::span<uint8_t> buffer) const noexcept;
+        [[nodiscard]] size_t read(std::span<uint8_t> buffer,
+                                  TickType_t timeout = pdMS_TO_TICKS(100)) const noexcept;
 
         /**
          * @brief Записать данные из предоставленного буфера
@@ -108,24 +119,61 @@ namespace net
          */
         [[nodiscard]] size_t write(std::span<const uint8_t> data) const noexcept;
 
+        /**
+         * @brief Установить режим кадрирования потока
+         * @param framing Режим (по умолчанию Framing::RAW)
+         * @note Framing::COBS меняет формат потока и включается на обеих сторонах канала
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_STATE, если рабочий поток запущен
+         */
+        [[nodiscard]] esp_err_t setFraming(Framing framing);
+
+        /**
+         * @brief Получить режим кадрирования потока
+         */
+        [[nodiscard]] Framing framing() const;
+
+        /**
+         * @brief Установить контроль целостности пакетов (трейлер CRC внутри кадра COBS)
+         * @param integrity Вид контрольной суммы (по умолчанию Integrity::NONE)
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_STATE, если рабочий поток запущен
+         * @note Пакеты с неверной суммой отбрасываются при приёме. Действует только
+         *       вместе с Framing::COBS (см. setFraming())
+         */
+        [[nodiscard]] esp_err_t setIntegrity(Integrity integrity);
+
+        /**
+         * @brief Получить режим контроля целостности
+         */
+        [[nodiscard]] Integrity integrity() const;
+
+        /**
+         * @brief Количество отброшенных принятых кадров (кадрирование или контрольная сумма)
+         */
+        [[nodiscard]] size_t frameErrors() const;
+
     protected:
         /**
          * @brief Отправить пакет данных
-         * @param packet Ссылка на пакет для отправки
+         * @param packet Дескриптор пакета для отправки
          * @return esp_err_t Код ошибки ESP-IDF
          */
-        [[nodiscard]] esp_err_t sendImpl(Packet& packet) override;
+        [[nodiscard]] esp_err_t sendImpl(const PacketRef& packet, Priority priority) override;
 
         /**
          * @brief Обработка принятых данных
-         * @details Выполняется в бесконечном цикле, пока работает задача
-         * @return Никогда не возвращает управление (бесконечный цикл)
+         * @details Обрабатывает одно событие драйвера UART, если waitForEvents() выбрал очередь событий.
+         *          В режиме COBS читает все доступные байты и передаёт в callback каждый собранный кадр
          */
-        void processReceivedData() override;
+        void processReceivedData(QueueSetMemberHandle_t source) override;
 
     private:
-        const SerialType mType; ///< Тип последовательного порта
-        uart_port_t mUartNum;   ///< Номер UART порта
+        const SerialType mType;               ///< Тип последовательного порта
+        uart_port_t mUartNum;                 ///< Номер UART порта
+        QueueHandle_t mEventQueue = nullptr; ///< Очередь событий драйвера UART
+        mutable std::mutex mReadMutex;       ///< Мьютекс чтения (не пересекается с отправкой)
+
+        StreamCodec mCodec;                    ///< Кадрирование и контроль целостности потока
+        std::array<uint8_t, MAX_MTU> mChunk{}; ///< Порция принятого потока (используется рабочим потоком)
     };
 } // namespace net
 
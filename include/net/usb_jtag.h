@@ -2,6 +2,9 @@
 #define NET_USB_JTAG_H
 
 #include "transport.h"
+#include "framing.h"
+
+#include <array>
 
 namespace net
 {
@@ -16,11 +19,13 @@ namespace net
 
         static constexpr size_t USB_JTAG_TX_BUFFER_SIZE = 1024;  // 1KB TX (2 пакета + резерв)
         static constexpr size_t USB_JTAG_RX_BUFFER_SIZE = 1536;  // 1.5KB RX (3 пакета)
+        static constexpr uint32_t RX_POLL_INTERVAL_MS = 10;      // Период опроса приёма (драйвер не сообщает о данных)
 
         /**
          * @brief Конструктор USB-JTAG
+         * @param transportConfig Параметры рабочего потока и очередей (без ограничения скорости, если pacing не задан)
          */
-        explicit UsbJtag() noexcept;
+        explicit UsbJtag(const TransportConfig& transportConfig = {}) noexcept;
         ~UsbJtag() override;
 
         // Запрещаем копирование и перемещение
@@ -38,10 +43,12 @@ namespace net
         /**
          * @brief Прочитать данные в предоставленный буфер
          * @param buffer Буфер для чтения данных (диапазон uint8_t)
+         * @param timeout Максимальное время ожидания данных
          * @return Количество фактически прочитанных байт
          * @note Если буфер пуст или USB-JTAG не инициализирован, вернёт 0
          */
-        [[nodiscard]] size_t read(std::span<uint8_t> buffer) const noexcept;
+        [[nodiscard]] size_t read(std::span<uint8_t> buffer,
+                                  TickType_t timeout = pdMS_TO_TICKS(50)) const noexcept;
 
         /**
          * @brief Записать данные из предоставленного буфера
@@ -51,18 +58,63 @@ namespace net
          */
         [[nodiscard]] size_t write(std::span<const uint8_t> data) const noexcept;
 
+        /**
+         * @brief Установить режим кадрирования потока
+         * @param framing Режим (по умолчанию Framing::RAW)
+         * @note Framing::COBS меняет формат потока и включается на обеих сторонах канала
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_STATE, если рабочий поток запущен
+         */
+        [[nodiscard]] esp_err_t setFraming(Framing framing);
+
+        /**
+         * @brief Получить режим кадрирования потока
+         */
+        [[nodiscard]] Framing framing() const;
+
+        /**
+         * @brief Установить контроль целостности пакетов (трейлер CRC внутри кадра COBS)
+         * @param integrity Вид контрольной суммы (по умолчанию Integrity::NONE)
+         * @return esp_err_t ESP_OK или ESP_ERR_INVALID_STATE, если рабочий поток запущен
+         * @note Пакеты с неверной суммой отбрасываются при приёме. Действует только
+         *       вместе с Framing::COBS (см. setFraming())
+         */
+        [[nodiscard]] esp_err_t setIntegrity(Integrity integrity);
+
+        /**
+         * @brief Получить режим контроля целостности
+         */
+        [[nodiscard]] Integrity integrity() const;
+
+        /**
+         * @brief Количество отброшенных принятых кадров (кадрирование или контрольная сумма)
+         */
+        [[nodiscard]] size_t frameErrors() const;
+
     protected:
         /**
          * @brief Отправить пакет данных
-         * @param packet Ссылка на пакет для отправки
+         * @param packet Дескриптор пакета для отправки
          * @return esp_err_t Код ошибки ESP-IDF
          */
-        [[nodiscard]] esp_err_t sendImpl(Packet& packet) override;
+        [[nodiscard]] esp_err_t sendImpl(const PacketRef& packet, Priority priority) override;
 
         /**
-         * @brief Обработка принятых данных
+         * @brief Обработка принятых данных (без блокировки)
          */
-        void processReceivedData() override;
+        void processReceivedData(QueueSetMemberHandle_t source) override;
+
+        /**
+         * @brief Интервал опроса приёма
+         * @return TickType_t RX_POLL_INTERVAL_MS в тиках
+         */
+        [[nodiscard]] TickType_t receivePollInterval() const noexcept override;
+
+    private:
+        bool mDriverInstalled = false; ///< Драйвер USB-JTAG установлен
+        mutable std::mutex mReadMutex; ///< Мьютекс чтения (не пересекается с отправкой)
+
+        StreamCodec mCodec;                    ///< Кадрирование и контроль целостности потока
+        std::array<uint8_t, MAX_MTU> mChunk{}; ///< Порция принятого потока (используется рабочим потоком)
     };
 } // namespace net
 
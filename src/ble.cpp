@@ -5,9 +5,11 @@
 #include "esp_bt_main.h"
 #include "esp_gap_ble_api.h"
 #include "esp_gatts_api.h"
+#include "esp_gatt_common_api.h"
 
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 
 #include <cstring>
 #include <cinttypes>
@@ -21,12 +23,22 @@ static net::BLE* sBLEInstance = nullptr;
 
 namespace net
 {
-    BLE::BLE(std::string deviceName, const BleConfig::Preset preset) :
-        Transport(TAG),
+    BLE::BLE(std::string deviceName, const BleConfig::Preset preset, const TransportConfig& transportConfig) :
+        Transport(TAG, transportConfig),
         mConfig(preset),
-        mDeviceName(std::move(deviceName))
+        mDeviceName(std::move(deviceName)),
+        mRxQueue(transportConfig.rxQueueDepth)
     {
         sBLEInstance = this;
+
+        if (transportConfig.rxQueueDepth == 0 || transportConfig.rxQueueDepth > HandleQueue::MAX_SIZE)
+        {
+            ESP_LOGW(TAG, "RX queue depth %zu out of range, clamped to 1..%zu",
+                     transportConfig.rxQueueDepth, HandleQueue::MAX_SIZE);
+        }
+
+        // Скорость определяет управление потоком соединений, общая очередь только распределяет пакеты
+        if (!transportConfig.pacing) setPacing(PacingPolicy::unpaced());
         ESP_LOGD(TAG, "Instance created");
     }
 
@@ -46,9 +58,9 @@ namespace net
             return ESP_OK;
         }
 
-        if (mDeviceName.empty() || !mDataCallback)
+        if (mDeviceName.empty() || !hasReceiver())
         {
-            ESP_LOGE(TAG, "Invalid parameters: empty name or null callback");
+            ESP_LOGE(TAG, "Invalid parameters: empty name or no receiver");
             return ESP_ERR_INVALID_ARG;
         }
 
@@ -119,6 +131,14 @@ namespace net
             return ret;
         }
 
+        // Обмен MTU инициирует клиент; сервер объявляет поддерживаемый размер
+        ret = esp_ble_gatt_set_local_mtu(mConfig.connection.mtu);
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Set local MTU %u failed: %s", mConfig.connection.mtu, esp_err_to_name(ret));
+            return ret;
+        }
+
         setInitialized(true);
 
         // Устанавливаем предпочтительные параметры PHY по умолчанию
@@ -383,10 +403,10 @@ namespace net
         }
 
         // Устанавливаем предпочтительные PHY для всех соединений
-        for (const auto& [connId, address] : mActiveConnections)
+        for (const auto& conn : mActiveConnections)
         {
             const esp_err_t ret = esp_ble_gap_set_preferred_phy(
-                const_cast<uint8_t*>(address), // [in] MAC-адрес устройства
+                const_cast<uint8_t*>(conn.address), // [in] MAC-адрес устройства
                 ESP_BLE_GAP_ALL_PHYS_PREF,     // [in] Все PHY доступны
                 txPhy,                         // [in] Предпочтения TX PHY
                 rxPhy,                         // [in] Предпочтения RX PHY
@@ -396,7 +416,7 @@ namespace net
             if (ret != ESP_OK)
             {
                 ESP_LOGE(TAG, "Failed to set PHY for conn %d: %s",
-                         connId, esp_err_to_name(ret));
+                         conn.connId, esp_err_to_name(ret));
                 return ret;
             }
         }
@@ -405,10 +425,12 @@ namespace net
         return esp_ble_gap_set_preferred_default_phy(txPhy, rxPhy);
     }
 
-    esp_err_t BLE::sendImpl(Packet& packet)
+    esp_err_t BLE::sendImpl(const PacketRef& packet, const Priority priority)
     {
-        // Обработка broadcast
-        if (packet.id == 0)
+        std::lock_guard lock(mMutex);
+
+        // Обработка broadcast: каждое соединение получает ссылку на общий буфер из пула
+        if (packet->id == 0)
         {
             if (mActiveConnections.empty())
             {
@@ -416,22 +438,206 @@ namespace net
                 return ESP_ERR_NOT_FOUND;
             }
 
-            esp_err_t finalRet = ESP_OK;
-            for (const auto& [connId, address] : mActiveConnections)
+            // Переполненная очередь одного соединения не задерживает остальные
+            size_t queued = peerQueued();
+            size_t accepted = 0;
+            for (auto& conn : mActiveConnections)
             {
-                if (const esp_err_t ret = sendToDevice(connId, packet.buffer, packet.size); ret != ESP_OK)
+                if (queued < PEER_QUEUE_BUDGET && conn.push(packet, priority))
+                {
+                    accepted++;
+                    queued++;
+                }
+                else
                 {
-                    finalRet = ret;
+                    ESP_LOGW(TAG, "Queue of conn %u is full, broadcast dropped for it", conn.connId);
                 }
             }
-            return finalRet;
+
+            // Пакет, не принятый никем, учитывает транспорт; частичная потеря - по соединениям
+            if (accepted == 0) return ESP_ERR_NOT_FINISHED;
+            for (size_t i = accepted; i < mActiveConnections.size(); i++)
+            {
+                mStats.onDrop(DropReason::PEER_OVERFLOW);
+            }
+            return ESP_OK;
         }
 
         // Отправка конкретному устройству
-        return sendToDevice(packet.id, packet.buffer, packet.size);
+        DeviceConnection* conn = findConnection(packet->id);
+        if (!conn)
+        {
+            ESP_LOGE(TAG, "Connection %u not found", packet->id);
+            return ESP_ERR_NOT_FOUND;
+        }
+
+        if (peerQueued() >= PEER_QUEUE_BUDGET || !conn->push(packet, priority))
+        {
+            ESP_LOGW(TAG, "Queue of conn %u is full, packet dropped", conn->connId);
+            return ESP_ERR_NOT_FINISHED;
+        }
+        return ESP_OK;
+    }
+
+    int64_t BLE::processTransmit()
+    {
+        std::lock_guard lock(mMutex);
+        if (mActiveConnections.empty()) return -1;
+
+        const int64_t now = esp_timer_get_time();
+
+        // Один раунд DRR по всем соединениям; задержка - ближайшая из требуемых соединениями
+        int64_t delay = checkLinkSetup(now);
+        for (auto& conn : mActiveConnections)
+        {
+            if (const int64_t peerDelay = transmitPeer(conn, now); peerDelay >= 0)
+            {
+                delay = delay < 0 ? peerDelay : std::min(delay, peerDelay);
+            }
+        }
+
+        // Следующий раунд начинается со следующего соединения
+        mActiveConnections.splice(mActiveConnections.end(), mActiveConnections, mActiveConnections.begin());
+        return delay;
+    }
+
+    int64_t BLE::transmitPeer(DeviceConnection& conn, const int64_t now)
+    {
+        if (conn.txCount == 0)
+        {
+            conn.deficit = 0;
+            return -1;
+        }
+
+        // Передача возобновится по событию снятия перегрузки
+        if (conn.congested) return -1;
+
+        if (conn.credits == 0)
+        {
+            if (const int64_t elapsed = now - conn.creditTime; elapsed < CREDIT_TIMEOUT_US)
+            {
+                return CREDIT_TIMEOUT_US - elapsed;
+            }
+
+            ESP_LOGW(TAG, "No confirmations from conn %u, credits restored", conn.connId);
+            conn.credits = NOTIFY_CREDITS;
+        }
+
+        const bool fragmentation = mConfig.gatt.fragmentation;
+        const size_t payload = conn.payloadSize();
+        const size_t quantum = fragmentation ? payload - FragmentHeader::SIZE : payload;
+
+        // Уведомления отправляются подряд, пока есть кредиты и кредит DRR
+        conn.deficit += quantum;
+        while (conn.txCount > 0 && conn.credits > 0 && !conn.congested)
+        {
+            const PacketRef& packet = conn.front();
+            const size_t chunk = fragmentation ? std::min(packet->size - conn.txOffset, quantum) : packet->size;
+            if (chunk > conn.deficit) break;
+
+            esp_err_t ret;
+            if (fragmentation)
+            {
+                const size_t len = writeFragment(*packet, conn.txOffset, conn.txFragment,
+                                                 std::span(mTxFrame).first(payload));
+                ret = sendToDevice(conn.connId, std::span(mTxFrame).first(len + FragmentHeader::SIZE));
+            }
+            else if (chunk <= payload)
+            {
+                ret = sendToDevice(conn.connId, std::span(packet->buffer).first(chunk));
+            }
+            else
+            {
+                ESP_LOGE(TAG, "Packet of %zu bytes exceeds MTU %u of conn %u", chunk, conn.link.mtu, conn.connId);
+                ret = ESP_ERR_INVALID_SIZE;
+            }
+
+            if (isTemporary(ret))
+            {
+                // Фрагмент остаётся первым в очереди соединения; остальные соединения продолжают передачу
+                return PEER_RETRY_US;
+            }
+
+            conn.deficit -= chunk;
+            if (ret != ESP_OK)
+            {
+                mStats.onSendError(ret);
+                mStats.onDrop(DropReason::SEND_ERROR);
+            }
+
+            if (ret == ESP_OK)
+            {
+                conn.credits--;
+                conn.creditTime = now;
+                conn.txOffset += chunk;
+                conn.txFragment++;
+
+                // Пакет освобождается после передачи последнего фрагмента
+                if (conn.txOffset < packet->size) continue;
+            }
+            else
+            {
+                reportError(*packet, ret);
+            }
+
+            conn.txOffset = 0;
+            conn.txFragment = 0;
+            conn.pop();
+        }
+
+        if (conn.txCount == 0)
+        {
+            conn.deficit = 0;
+            return -1;
+        }
+
+        // Без кредитов ждём подтверждения стека (или таймаута), иначе - следующего раунда DRR
+        return conn.credits == 0 ? CREDIT_TIMEOUT_US : 0;
+    }
+
+    BLE::DeviceConnection* BLE::findConnection(const uint16_t connId) noexcept
+    {
+        const auto it = std::ranges::find_if(mActiveConnections,
+                                             [connId](const auto& conn) { return conn.connId == connId; });
+        return it != mActiveConnections.end() ? &*it : nullptr;
+    }
+
+    size_t BLE::peerQueued() const noexcept
+    {
+        size_t count = 0;
+        for (const auto& conn : mActiveConnections) count += conn.txCount;
+        return count;
+    }
+
+    bool BLE::DeviceConnection::push(const PacketRef& packet, const Priority priority) noexcept
+    {
+        if (txCount == txQueue.size()) return false;
+
+        // Сдвигаем в конец пакеты более низких классов; BLE не ограничивает скорость общей очереди,
+        // поэтому порядок классов сохраняется только здесь
+        const size_t first = txOffset > 0 ? 1 : 0;
+        size_t position = txCount;
+        while (position > first && txQueue[(txHead + position - 1) % txQueue.size()].priority > priority)
+        {
+            txQueue[(txHead + position) % txQueue.size()] = std::move(txQueue[(txHead + position - 1) % txQueue.size()]);
+            position--;
+        }
+
+        txQueue[(txHead + position) % txQueue.size()] = {packet, priority};
+        txCount++;
+        return true;
     }
 
-    esp_err_t BLE::sendToDevice(uint16_t connId, std::array<uint8_t, MAX_MTU>& buffer, const size_t size) const noexcept
+    void BLE::DeviceConnection::pop() noexcept
+    {
+        if (txCount == 0) return;
+
+        txQueue[txHead] = {};
+        txHead = (txHead + 1) % txQueue.size();
+        txCount--;
+    }
+
+    esp_err_t BLE::sendToDevice(const uint16_t connId, const std::span<uint8_t> data) const noexcept
     {
         // Поиск соединения
         const auto it = std::ranges::find_if(mActiveConnections,
@@ -445,7 +651,7 @@ namespace net
 
         // Оптимизированная отправка через кэшированные параметры
         const esp_err_t ret = esp_ble_gatts_send_indicate(
-            mGattsIf, connId, mCharHandle, size, buffer.data(), false);
+            mGattsIf, connId, mCharHandle, data.size(), data.data(), false);
 
         if (ret != ESP_OK)
         {
@@ -459,6 +665,9 @@ namespace net
     {
         Transport::stop();
 
+        // Рабочий поток остановлен: непереданные принятые пакеты освобождаются
+        mRxQueue.clear();
+
         std::lock_guard lock(mMutex);
         if (!isInitialized()) return;
 
@@ -507,7 +716,146 @@ namespace net
     size_t BLE::getMtuSize() const noexcept
     {
         std::lock_guard lock(mMutex);
-        return mMtu;
+        if (mConfig.gatt.fragmentation) return MAX_MTU;
+
+        // Без фрагментации пакет должен помещаться в одно уведомление каждого соединения
+        size_t size = DEFAULT_MTU - ATT_HEADER_SIZE;
+        if (!mActiveConnections.empty())
+        {
+            size = std::ranges::min(mActiveConnections, {},
+                                    [](const DeviceConnection& conn) { return conn.link.mtu; }).payloadSize();
+        }
+        return size;
+    }
+
+    uint16_t BLE::getConnectionMtu(const uint16_t connId) const noexcept
+    {
+        std::lock_guard lock(mMutex);
+        const auto it = std::ranges::find_if(mActiveConnections,
+                                             [connId](const auto& conn) { return conn.connId == connId; });
+        return it != mActiveConnections.cend() ? it->link.mtu : 0;
+    }
+
+    std::optional<BLE::LinkInfo> BLE::getLinkInfo(const uint16_t connId) const
+    {
+        std::lock_guard lock(mMutex);
+        const auto it = std::ranges::find_if(mActiveConnections,
+                                             [connId](const auto& conn) { return conn.connId == connId; });
+        if (it == mActiveConnections.cend()) return std::nullopt;
+        return it->link;
+    }
+
+    void BLE::setLinkCallback(LinkFunction callback)
+    {
+        std::lock_guard lock(mMutex);
+        mLinkCallback = std::move(callback);
+    }
+
+    void BLE::startLinkSetup()
+    {
+        if (std::ranges::any_of(mActiveConnections, &DeviceConnection::isSettingUp)) return;
+
+        const auto it = std::ranges::find(mActiveConnections, LinkStage::PENDING, &DeviceConnection::stage);
+        if (it != mActiveConnections.end()) advanceLinkSetup(*it);
+    }
+
+    void BLE::advanceLinkSetup(DeviceConnection& conn)
+    {
+        const auto& params = mConfig.connection;
+
+        while (conn.stage != LinkStage::READY)
+        {
+            conn.stage = static_cast<LinkStage>(static_cast<uint8_t>(conn.stage) + 1);
+            conn.stageTime = esp_timer_get_time();
+
+            bool requested = false;
+            esp_err_t ret = ESP_OK;
+            switch (conn.stage)
+            {
+            case LinkStage::DATA_LENGTH:
+                if (params.dataLength != 0)
+                {
+                    ret = esp_ble_gap_set_pkt_data_len(conn.address, params.dataLength);
+                    requested = true;
+                }
+                break;
+
+            case LinkStage::PHY:
+                // PHY 2M и Coded доступны только при включённых функциях BLE 5.0
+                if (mConfig.controller.ble_50_feat_supp)
+                {
+                    ret = esp_ble_gap_set_preferred_phy(conn.address, 0, params.txPhy, params.rxPhy,
+                                                        ESP_BLE_GAP_PHY_OPTION_NO_PREF);
+                    requested = true;
+                }
+                break;
+
+            case LinkStage::CONN_PARAMS:
+                if (params.minInterval != 0)
+                {
+                    esp_ble_conn_update_params_t update = {};
+                    memcpy(update.bda, conn.address, ESP_BD_ADDR_LEN);
+                    update.min_int = params.minInterval;
+                    update.max_int = std::max(params.minInterval, params.maxInterval);
+                    update.latency = params.latency;
+                    update.timeout = params.timeout;
+                    ret = esp_ble_gap_update_conn_params(&update);
+                    requested = true;
+                }
+                break;
+
+            default:
+                break;
+            }
+
+            // Ожидаем событие завершения шага
+            if (requested && ret == ESP_OK) return;
+
+            if (ret != ESP_OK)
+            {
+                ESP_LOGW(TAG, "Link setup step %u of conn %u failed: %s",
+                         static_cast<unsigned>(conn.stage), conn.connId, esp_err_to_name(ret));
+            }
+        }
+
+        conn.link.ready = true;
+        reportLink(conn);
+        startLinkSetup();
+    }
+
+    void BLE::reportLink(const DeviceConnection& conn) const
+    {
+        const LinkInfo& link = conn.link;
+        ESP_LOGI(TAG, "Link conn %u: MTU %u, data length %u, PHY %u/%u, interval %.2f ms, latency %u, timeout %u ms",
+                 conn.connId, link.mtu, link.txOctets, link.txPhy, link.rxPhy,
+                 link.interval * 1.25f, link.latency, link.timeout * 10);
+
+        if (mLinkCallback) mLinkCallback(conn.connId, link);
+    }
+
+    int64_t BLE::checkLinkSetup(const int64_t now)
+    {
+        const auto it = std::ranges::find_if(mActiveConnections, &DeviceConnection::isSettingUp);
+        if (it == mActiveConnections.end()) return -1;
+
+        if (const int64_t elapsed = now - it->stageTime; elapsed < LINK_STEP_TIMEOUT_US)
+        {
+            return LINK_STEP_TIMEOUT_US - elapsed;
+        }
+
+        // Стек не прислал событие завершения (например, устройство не поддерживает функцию)
+        ESP_LOGW(TAG, "Link setup step %u of conn %u timed out",
+                 static_cast<unsigned>(it->stage), it->connId);
+        advanceLinkSetup(*it);
+        return 0;
+    }
+
+    void BLE::setAutoPacing(const bool enable)
+    {
+        std::lock_guard lock(mMutex);
+        mAutoPacing = enable;
+
+        setPacing(enable ? PacingPolicy::unpaced() : PacingPolicy::packets(1000000 / SEND_INTERVAL_US));
     }
 
     std::shared_ptr<const BleConfig> BLE::getConfig() const
@@ -568,13 +916,17 @@ namespace net
         case ESP_GATTS_CONNECT_EVT:
             {
                 std::lock_guard lock(sBLEInstance->mMutex);
-                DeviceConnection conn = {
-                    .connId = param->connect.conn_id,
-                    .address = {}
-                };
+                auto& conn = sBLEInstance->mActiveConnections.emplace_back();
+                conn.connId = param->connect.conn_id;
+                conn.link.interval = param->connect.conn_params.interval;
+                conn.link.latency = param->connect.conn_params.latency;
+                conn.link.timeout = param->connect.conn_params.timeout;
                 memcpy(conn.address, param->connect.remote_bda, ESP_BD_ADDR_LEN);
-                sBLEInstance->mActiveConnections.push_back(conn);
-                ESP_LOGI(TAG, "Device connected. Conn_id: %d", param->connect.conn_id);
+                ESP_LOGI(TAG, "Device connected. Conn_id: %d, interval: %u",
+                         param->connect.conn_id, conn.link.interval);
+
+                // Настройка канала: DLE -> PHY -> параметры соединения
+                sBLEInstance->startLinkSetup();
                 break;
             }
 
@@ -592,10 +944,14 @@ namespace net
                         return conn.connId == conn_id;
                     });
 
+                // Пакеты из очереди соединения освобождаются вместе с ним
                 if (sBLEInstance->mActiveConnections.size() < before)
                 {
                     ESP_LOGI(TAG, "Device disconnected. Conn_id: %d", conn_id);
                 }
+
+                // Отключившееся соединение могло находиться в настройке
+                sBLEInstance->startLinkSetup();
                 break;
             }
 
@@ -603,10 +959,47 @@ namespace net
             sBLEInstance->handleWriteEvent(param->write.conn_id, param);
             break;
 
+        case ESP_GATTS_CONGEST_EVT:
+            {
+                std::lock_guard lock(sBLEInstance->mMutex);
+                if (DeviceConnection* conn = sBLEInstance->findConnection(param->congest.conn_id))
+                {
+                    conn->congested = param->congest.congested;
+                    ESP_LOGD(TAG, "Conn %u %s", conn->connId, conn->congested ? "congested" : "uncongested");
+                }
+                if (!param->congest.congested) sBLEInstance->notifyWorker();
+                break;
+            }
+
+        case ESP_GATTS_CONF_EVT:
+            {
+                // Стек передал уведомление - возвращаем кредит соединению
+                std::lock_guard lock(sBLEInstance->mMutex);
+                if (DeviceConnection* conn = sBLEInstance->findConnection(param->conf.conn_id))
+                {
+                    if (conn->credits < NOTIFY_CREDITS) conn->credits++;
+                    conn->creditTime = esp_timer_get_time();
+                }
+                if (param->conf.status != ESP_GATT_OK)
+                {
+                    ESP_LOGW(TAG, "Notification to conn %u failed: status %d",
+                             param->conf.conn_id, param->conf.status);
+                }
+                sBLEInstance->notifyWorker();
+                break;
+            }
+
         case ESP_GATTS_MTU_EVT:
-            sBLEInstance->mMtu = param->mtu.mtu > MAX_MTU ? MAX_MTU : param->mtu.mtu;
-            ESP_LOGI(TAG, "MTU updated: %d", sBLEInstance->mMtu);
-            break;
+            {
+                std::lock_guard lock(sBLEInstance->mMutex);
+                if (DeviceConnection* conn = sBLEInstance->findConnection(param->mtu.conn_id))
+                {
+                    conn->link.mtu = std::clamp<uint16_t>(param->mtu.mtu, DEFAULT_MTU, MAX_MTU);
+                    ESP_LOGI(TAG, "MTU of conn %u updated: %u", conn->connId, conn->link.mtu);
+                    if (conn->link.ready) sBLEInstance->reportLink(*conn);
+                }
+                break;
+            }
 
         default:
             ESP_LOGD(TAG, "Unhandled GATTS event: %d", event);
@@ -623,17 +1016,87 @@ namespace net
         switch (event)
         {
         case ESP_GAP_BLE_PHY_UPDATE_COMPLETE_EVT:
-            if (param->phy_update.status == ESP_OK)
             {
-                ESP_LOGI(TAG, "PHY updated: TX=%d, RX=%d",
-                         param->phy_update.tx_phy, param->phy_update.rx_phy);
+                std::lock_guard lock(sBLEInstance->mMutex);
+                const bool success = param->phy_update.status == ESP_BT_STATUS_SUCCESS;
+                if (success)
+                {
+                    ESP_LOGI(TAG, "PHY updated: TX=%d, RX=%d",
+                             param->phy_update.tx_phy, param->phy_update.rx_phy);
+                }
+                else
+                {
+                    ESP_LOGE(TAG, "PHY update failed: status %d", param->phy_update.status);
+                }
+
+                for (auto& conn : sBLEInstance->mActiveConnections)
+                {
+                    if (memcmp(conn.address, param->phy_update.bda, ESP_BD_ADDR_LEN) != 0) continue;
+
+                    if (success)
+                    {
+                        conn.link.txPhy = param->phy_update.tx_phy;
+                        conn.link.rxPhy = param->phy_update.rx_phy;
+                    }
+
+                    if (conn.stage == LinkStage::PHY) sBLEInstance->advanceLinkSetup(conn);
+                    else if (success && conn.link.ready) sBLEInstance->reportLink(conn);
+                }
+                break;
             }
-            else
+
+        case ESP_GAP_BLE_SET_PKT_LENGTH_COMPLETE_EVT:
             {
-                ESP_LOGE(TAG, "PHY update failed: %s",
-                         esp_err_to_name(param->phy_update.status));
+                // Событие не содержит адреса: оно относится к соединению на шаге DATA_LENGTH
+                std::lock_guard lock(sBLEInstance->mMutex);
+                const auto it = std::ranges::find(sBLEInstance->mActiveConnections,
+                                                  LinkStage::DATA_LENGTH, &DeviceConnection::stage);
+                if (it == sBLEInstance->mActiveConnections.end()) break;
+
+                if (param->pkt_data_length_cmpl.status == ESP_BT_STATUS_SUCCESS)
+                {
+                    it->link.txOctets = param->pkt_data_length_cmpl.params.tx_len;
+                }
+                else
+                {
+                    ESP_LOGW(TAG, "Data length update of conn %u failed: status %d",
+                             it->connId, param->pkt_data_length_cmpl.status);
+                }
+                sBLEInstance->advanceLinkSetup(*it);
+                break;
+            }
+
+        case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT:
+            {
+                std::lock_guard lock(sBLEInstance->mMutex);
+                const bool success = param->update_conn_params.status == ESP_BT_STATUS_SUCCESS;
+                if (success)
+                {
+                    ESP_LOGI(TAG, "Connection params updated: interval=%u, latency=%u, timeout=%u",
+                             param->update_conn_params.conn_int, param->update_conn_params.latency,
+                             param->update_conn_params.timeout);
+                }
+                else
+                {
+                    ESP_LOGW(TAG, "Connection params update failed: status %d", param->update_conn_params.status);
+                }
+
+                for (auto& conn : sBLEInstance->mActiveConnections)
+                {
+                    if (memcmp(conn.address, param->update_conn_params.bda, ESP_BD_ADDR_LEN) != 0) continue;
+
+                    if (success)
+                    {
+                        conn.link.interval = param->update_conn_params.conn_int;
+                        conn.link.latency = param->update_conn_params.latency;
+                        conn.link.timeout = param->update_conn_params.timeout;
+                    }
+
+                    if (conn.stage == LinkStage::CONN_PARAMS) sBLEInstance->advanceLinkSetup(conn);
+                    else if (success && conn.link.ready) sBLEInstance->reportLink(conn);
+                }
+                break;
             }
-            break;
 
         case ESP_GAP_BLE_EXT_ADV_DATA_SET_COMPLETE_EVT:
             if (param->ext_adv_data_set.status != ESP_OK)
@@ -837,10 +1300,10 @@ namespace net
 
         std::lock_guard lock(mMutex);
 
-        // Проверка callback
-        if (mDataCallback == nullptr)
+        // Проверка получателя (callback данных или пересылка)
+        if (!hasReceiver())
         {
-            ESP_LOGE(TAG, "Data callback is null. Conn: %u", connId);
+            ESP_LOGE(TAG, "No receiver for data. Conn: %u", connId);
             return;
         }
 
@@ -863,21 +1326,32 @@ namespace net
 
         // Создание и заполнение пакета
         Packet packet;
-        packet.id = connId;
+        bool complete = true;
 
-        if (!packet.setPayload(param->write.value, dataLen))
+        if (mConfig.gatt.fragmentation)
+        {
+            complete = reassemble(connId, {param->write.value, dataLen}, packet);
+        }
+        else if (!packet.setPayload(param->write.value, dataLen))
         {
             ESP_LOGE(TAG, "Payload set failed. Conn: %u, Size: %zu", connId, dataLen);
             return;
         }
+        packet.id = connId;
 
-        // Вызов callback
-        mDataCallback->invoke(packet, [&](const Packet& result)
+        // Callback вызывает рабочий поток (для фрагментированных данных - после сборки всего пакета)
+        if (complete)
         {
-            send(result);
-        });
+            PacketRef ref = PacketPool::instance().acquire(packet, poolReservation());
+            if (!ref || !mRxQueue.push(ref))
+            {
+                ESP_LOGW(TAG, "RX queue full, packet dropped. Conn: %u", connId);
+                mStats.onDrop(DropReason::RX_OVERFLOW);
+            }
+            notifyWorker();
+        }
 
-        // Отправка подтверждения
+        // Отправка подтверждения, не дожидаясь обработки данных
         const esp_err_t ret = esp_ble_gatts_send_response(
             mGattsIf,
             connId,
@@ -892,4 +1366,39 @@ namespace net
                      connId, esp_err_to_name(ret));
         }
     }
+
+    void BLE::processReceivedData(QueueSetMemberHandle_t)
+    {
+        for (size_t pending = mRxQueue.size(); pending > 0; pending--)
+        {
+            const PacketRef packet = mRxQueue.pop();
+            if (!packet) break;
+
+            dispatchReceived(*packet);
+        }
+    }
+
+    bool BLE::reassemble(const uint16_t connId, const std::span<const uint8_t> data, Packet& packet)
+    {
+        DeviceConnection* conn = findConnection(connId);
+        if (!conn)
+        {
+            ESP_LOGW(TAG, "Fragment from unknown conn %u", connId);
+            return false;
+        }
+
+        switch (conn->rx.push(data))
+        {
+        case Reassembler::Result::COMPLETE:
+            packet = conn->rx.packet();
+            return true;
+
+        case Reassembler::Result::ERROR:
+            ESP_LOGW(TAG, "Broken fragment sequence, packet dropped. Conn: %u", connId);
+            return false;
+
+        default:
+            return false;
+        }
+    }
 } // namespace net
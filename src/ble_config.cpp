@@ -79,6 +79,12 @@ namespace net
             extAdvParams.interval_max = 0x60; // 60ms
             connection.txPhy = ESP_BLE_GAP_PHY_2M;
             connection.rxPhy = ESP_BLE_GAP_PHY_2M;
+            connection.mtu = 517;
+            connection.dataLength = 251;
+            connection.minInterval = 6;  // 7.5ms
+            connection.maxInterval = 12; // 15ms
+            connection.latency = 0;
+            connection.timeout = 400; // 4s
             break;
 
         case Preset::BLE5_DEFAULT:
@@ -89,6 +95,12 @@ namespace net
             extAdvParams.interval_max = 0x100; // 160ms
             connection.txPhy = ESP_BLE_GAP_PHY_2M | ESP_BLE_GAP_PHY_1M;
             connection.rxPhy = ESP_BLE_GAP_PHY_2M | ESP_BLE_GAP_PHY_1M;
+            connection.mtu = 247;
+            connection.dataLength = 251;
+            connection.minInterval = 24; // 30ms
+            connection.maxInterval = 40; // 50ms
+            connection.latency = 0;
+            connection.timeout = 400; // 4s
             break;
 
         case Preset::BLE5_LOW_POWER:
@@ -99,6 +111,12 @@ namespace net
             extAdvParams.interval_max = 0x400; // 640ms
             connection.txPhy = ESP_BLE_GAP_PHY_1M;
             connection.rxPhy = ESP_BLE_GAP_PHY_1M;
+            connection.mtu = 185;
+            connection.dataLength = 0;
+            connection.minInterval = 80;  // 100ms
+            connection.maxInterval = 160; // 200ms
+            connection.latency = 4;
+            connection.timeout = 600; // 6s
             break;
 
         default: ;
@@ -126,18 +144,36 @@ namespace net
             controller.txpwr_dft = ESP_PWR_LVL_P9;
             legacyAdvParams.adv_int_min = 0x20; // 20ms
             legacyAdvParams.adv_int_max = 0x30; // 30ms
+            connection.mtu = 247;
+            connection.dataLength = 251;
+            connection.minInterval = 12; // 15ms
+            connection.maxInterval = 24; // 30ms
+            connection.latency = 0;
+            connection.timeout = 400; // 4s
             break;
 
         case Preset::BLE4_DEFAULT:
             controller.txpwr_dft = ESP_PWR_LVL_P6;
             legacyAdvParams.adv_int_min = 0x40; // 40ms
             legacyAdvParams.adv_int_max = 0x60; // 60ms
+            connection.mtu = 247;
+            connection.dataLength = 251;
+            connection.minInterval = 0; // Интервал выбирает центральное устройство
+            connection.maxInterval = 0;
+            connection.latency = 0;
+            connection.timeout = 400; // 4s
             break;
 
         case Preset::BLE4_LOW_POWER:
             controller.txpwr_dft = ESP_PWR_LVL_N12;
             legacyAdvParams.adv_int_min = 0x80; // 80ms
             legacyAdvParams.adv_int_max = 0xC0; // 120ms
+            connection.mtu = 185;
+            connection.dataLength = 0;
+            connection.minInterval = 80;  // 100ms
+            connection.maxInterval = 160; // 200ms
+            connection.latency = 4;
+            connection.timeout = 600; // 6s
             break;
 
         default: ;
@@ -0,0 +1,64 @@
+#include "net/channel.h"
+
+namespace net
+{
+    namespace
+    {
+        constexpr auto RELAXED = std::memory_order_relaxed;
+    }
+
+    void ChannelTable::setPriority(const uint8_t channel, const Priority priority) noexcept
+    {
+        if (channel < MAX_CHANNELS) mChannels[channel].priority.store(priority, RELAXED);
+    }
+
+    Priority ChannelTable::priority(const uint8_t channel) const noexcept
+    {
+        return channel < MAX_CHANNELS ? mChannels[channel].priority.load(RELAXED) : Priority::INTERACTIVE;
+    }
+
+    void ChannelTable::onQueued(const uint8_t channel, const size_t bytes) noexcept
+    {
+        if (channel >= MAX_CHANNELS) return;
+        mChannels[channel].packetsQueued.fetch_add(1, RELAXED);
+        mChannels[channel].bytesQueued.fetch_add(bytes, RELAXED);
+    }
+
+    void ChannelTable::onRejected(const uint8_t channel) noexcept
+    {
+        if (channel < MAX_CHANNELS) mChannels[channel].rejected.fetch_add(1, RELAXED);
+    }
+
+    void ChannelTable::onReceived(const uint8_t channel, const size_t bytes) noexcept
+    {
+        if (channel >= MAX_CHANNELS) return;
+        mChannels[channel].packetsReceived.fetch_add(1, RELAXED);
+        mChannels[channel].bytesReceived.fetch_add(bytes, RELAXED);
+    }
+
+    ChannelStats ChannelTable::stats(const uint8_t channel) const noexcept
+    {
+        if (channel >= MAX_CHANNELS) return {};
+
+        const Channel& state = mChannels[channel];
+        return {
+            .packetsQueued = state.packetsQueued.load(RELAXED),
+            .bytesQueued = state.bytesQueued.load(RELAXED),
+            .rejected = state.rejected.load(RELAXED),
+            .packetsReceived = state.packetsReceived.load(RELAXED),
+            .bytesReceived = state.bytesReceived.load(RELAXED)
+        };
+    }
+
+    void ChannelTable::resetStats() noexcept
+    {
+        for (Channel& state : mChannels)
+        {
+            state.packetsQueued.store(0, RELAXED);
+            state.bytesQueued.store(0, RELAXED);
+            state.rejected.store(0, RELAXED);
+            state.packetsReceived.store(0, RELAXED);
+            state.bytesReceived.store(0, RELAXED);
+        }
+    }
+} // namespace net
@@ -0,0 +1,56 @@
+#include "net/coalescing.h"
+
+#include <algorithm>
+
+namespace net
+{
+    bool appendRecord(Packet& batch, const Packet& packet, const size_t limit) noexcept
+    {
+        if (!packet.isValid() || batch.size + batchRecordSize(packet.size) > std::min<size_t>(limit, MAX_MTU))
+            return false;
+
+        uint8_t* out = batch.buffer.data() + batch.size;
+        if (packet.size < 0x80)
+        {
+            *out++ = static_cast<uint8_t>(packet.size);
+        }
+        else
+        {
+            *out++ = static_cast<uint8_t>(0x80 | packet.size >> 8);
+            *out++ = static_cast<uint8_t>(packet.size & 0xFF);
+        }
+
+        std::memcpy(out, packet.buffer.data(), packet.size);
+        batch.size = static_cast<uint16_t>(batch.size + batchRecordSize(packet.size));
+        return true;
+    }
+
+    bool BatchReader::next(Packet& out) noexcept
+    {
+        if (mFailed || mOffset >= mBatch.size) return false;
+
+        const uint8_t* data = mBatch.buffer.data();
+        size_t size = data[mOffset++];
+        if (size & 0x80)
+        {
+            if (mOffset >= mBatch.size)
+            {
+                mFailed = true;
+                return false;
+            }
+            size = (size & 0x7F) << 8 | data[mOffset++];
+        }
+
+        if (size == 0 || size > MAX_MTU || mOffset + size > mBatch.size)
+        {
+            mFailed = true;
+            return false;
+        }
+
+        out.id = mBatch.id;
+        out.size = static_cast<uint16_t>(size);
+        std::memcpy(out.buffer.data(), data + mOffset, size);
+        mOffset += size;
+        return true;
+    }
+} // namespace net
@@ -0,0 +1,113 @@
+#include "net/completion.h"
+
+#include <utility>
+
+namespace net
+{
+    CompletionPool::CompletionPool() noexcept
+    {
+        for (size_t i = 0; i < CAPACITY; i++)
+        {
+            mSlots[i].signal = xSemaphoreCreateBinaryStatic(&mSlots[i].signalBuffer);
+            (void)mFree.push(static_cast<CompletionId>(i + 1));
+        }
+    }
+
+    CompletionPool& CompletionPool::instance() noexcept
+    {
+        static CompletionPool pool;
+        return pool;
+    }
+
+    SendHandle CompletionPool::acquire(CompletionFunction callback) noexcept
+    {
+        CompletionId id = 0;
+        if (!mFree.pop(id)) return {0, ESP_ERR_NO_MEM};
+
+        Slot& entry = slot(id);
+        (void)xSemaphoreTake(entry.signal, 0);
+        entry.result = ESP_OK;
+        entry.callback = std::move(callback);
+        entry.state.store(Slot::PENDING, std::memory_order_relaxed);
+        entry.refs.store(1, std::memory_order_release);
+        return {id, ESP_OK};
+    }
+
+    void CompletionPool::retain(const CompletionId id) noexcept
+    {
+        if (id != 0) slot(id).refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CompletionPool::release(const CompletionId id) noexcept
+    {
+        if (id == 0) return;
+
+        if (slot(id).refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // Отправка, брошенная без завершения, не оставляет callback висящим
+            complete(id, ESP_ERR_INVALID_STATE);
+            slot(id).callback = nullptr;
+            (void)mFree.push(id);
+        }
+    }
+
+    void CompletionPool::complete(const CompletionId id, const esp_err_t result) noexcept
+    {
+        if (id == 0) return;
+
+        Slot& entry = slot(id);
+        uint8_t expected = Slot::PENDING;
+        if (!entry.state.compare_exchange_strong(expected, Slot::COMPLETING, std::memory_order_acquire)) return;
+
+        entry.result = result;
+        entry.state.store(Slot::DONE, std::memory_order_release);
+
+        // Callback вызывается один раз и освобождается сразу, вместе с захваченными им ресурсами
+        if (const CompletionFunction callback = std::exchange(entry.callback, nullptr)) callback(result);
+        xSemaphoreGive(entry.signal);
+    }
+
+    SendHandle::SendHandle(SendHandle&& other) noexcept :
+        mId(std::exchange(other.mId, 0)),
+        mImmediate(other.mImmediate)
+    {
+    }
+
+    SendHandle& SendHandle::operator=(SendHandle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            CompletionPool::instance().release(mId);
+            mId = std::exchange(other.mId, 0);
+            mImmediate = other.mImmediate;
+        }
+        return *this;
+    }
+
+    SendHandle::~SendHandle()
+    {
+        CompletionPool::instance().release(mId);
+    }
+
+    bool SendHandle::ready() const noexcept
+    {
+        if (mId == 0) return true;
+        return CompletionPool::instance().slot(mId).state.load(std::memory_order_acquire) == CompletionPool::Slot::DONE;
+    }
+
+    esp_err_t SendHandle::result() const noexcept
+    {
+        if (mId == 0) return mImmediate;
+        return ready() ? CompletionPool::instance().slot(mId).result : ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t SendHandle::wait(const TickType_t timeout) const noexcept
+    {
+        if (ready()) return result();
+
+        // Семафор выдаётся один раз; повторное ожидание завершённой отправки возвращается выше
+        auto& entry = CompletionPool::instance().slot(mId);
+        if (xSemaphoreTake(entry.signal, timeout) == pdTRUE) xSemaphoreGive(entry.signal);
+        return ready() ? result() : ESP_ERR_TIMEOUT;
+    }
+} // namespace net
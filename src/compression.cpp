@@ -0,0 +1,165 @@
+#include "net/compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace net
+{
+    namespace
+    {
+        constexpr size_t HASH_BITS = 8;                 ///< Разрядность хэша трёх байт
+        constexpr size_t HASH_SIZE = 1 << HASH_BITS;    ///< Размер хэш-таблицы компрессора
+        constexpr size_t MIN_MATCH = 3;                 ///< Минимальная длина повтора
+        constexpr size_t MAX_MATCH = MIN_MATCH + 0x1F;  ///< Максимальная длина повтора
+        constexpr size_t MAX_OFFSET = 1024;             ///< Максимальное смещение повтора
+        constexpr size_t MAX_LITERALS = 128;            ///< Максимальная длина серии литералов
+        constexpr uint16_t NO_POSITION = 0xFFFF;        ///< Пустая ячейка хэш-таблицы
+
+        size_t hash3(const uint8_t* data) noexcept
+        {
+            const uint32_t value = data[0] | data[1] << 8 | data[2] << 16;
+            return (value * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        /**
+         * @brief Записать серию литералов
+         * @return bool false - не хватает места в out
+         */
+        bool emitLiterals(const uint8_t* literals, size_t count, std::span<uint8_t> out, size_t& pos) noexcept
+        {
+            while (count > 0)
+            {
+                const size_t run = std::min(count, MAX_LITERALS);
+                if (pos + 1 + run > out.size()) return false;
+
+                out[pos++] = static_cast<uint8_t>(run - 1);
+                std::memcpy(out.data() + pos, literals, run);
+                pos += run;
+                literals += run;
+                count -= run;
+            }
+            return true;
+        }
+    } // namespace
+
+    size_t lzCompress(const std::span<const uint8_t> data, const std::span<uint8_t> out) noexcept
+    {
+        // Позиции хранятся в 16 битах: формат рассчитан на данные размером с пакет
+        if (data.size() >= NO_POSITION) return 0;
+
+        std::array<uint16_t, HASH_SIZE> table;
+        table.fill(NO_POSITION);
+
+        const uint8_t* src = data.data();
+        const size_t size = data.size();
+        size_t pos = 0;
+        size_t anchor = 0; // Начало ещё не записанных литералов
+        size_t i = 0;
+
+        while (i + MIN_MATCH <= size)
+        {
+            const size_t h = hash3(src + i);
+            const size_t candidate = table[h];
+            table[h] = static_cast<uint16_t>(i);
+
+            if (candidate == NO_POSITION || i - candidate > MAX_OFFSET ||
+                std::memcmp(src + candidate, src + i, MIN_MATCH) != 0)
+            {
+                i++;
+                continue;
+            }
+
+            size_t length = MIN_MATCH;
+            while (i + length < size && length < MAX_MATCH && src[candidate + length] == src[i + length])
+            {
+                length++;
+            }
+
+            if (!emitLiterals(src + anchor, i - anchor, out, pos) || pos + 2 > out.size()) return 0;
+
+            const size_t offset = i - candidate - 1;
+            out[pos++] = static_cast<uint8_t>(0x80 | (length - MIN_MATCH) << 2 | offset >> 8);
+            out[pos++] = static_cast<uint8_t>(offset & 0xFF);
+
+            i += length;
+            anchor = i;
+        }
+
+        if (!emitLiterals(src + anchor, size - anchor, out, pos)) return 0;
+        return pos;
+    }
+
+    size_t lzDecompress(const std::span<const uint8_t> data, const std::span<uint8_t> out) noexcept
+    {
+        size_t in = 0;
+        size_t pos = 0;
+
+        while (in < data.size())
+        {
+            const uint8_t token = data[in++];
+            if (!(token & 0x80))
+            {
+                const size_t run = token + 1;
+                if (in + run > data.size() || pos + run > out.size()) return 0;
+
+                std::memcpy(out.data() + pos, data.data() + in, run);
+                in += run;
+                pos += run;
+                continue;
+            }
+
+            if (in >= data.size()) return 0;
+
+            const size_t length = ((token >> 2) & 0x1F) + MIN_MATCH;
+            const size_t offset = ((token & 0x03) << 8 | data[in++]) + 1;
+            if (offset > pos || pos + length > out.size()) return 0;
+
+            // Повтор может перекрывать сам себя, поэтому копирование побайтовое
+            for (size_t k = 0; k < length; k++, pos++)
+            {
+                out[pos] = out[pos - offset];
+            }
+        }
+        return pos;
+    }
+
+    size_t compressPayload(const std::span<const uint8_t> data, const std::span<uint8_t> out) noexcept
+    {
+        if (out.size() < COMPRESSION_OVERHEAD) return 0;
+
+        // Сжатие выгодно, только если результат меньше исходных данных
+        const size_t limit = std::min(out.size() - COMPRESSION_OVERHEAD, data.size() > 0 ? data.size() - 1 : 0);
+        if (const size_t size = lzCompress(data, out.subspan(COMPRESSION_OVERHEAD, limit)); size > 0)
+        {
+            out[0] = COMPRESSION_LZ;
+            return size + COMPRESSION_OVERHEAD;
+        }
+
+        if (data.size() + COMPRESSION_OVERHEAD > out.size()) return 0;
+
+        out[0] = COMPRESSION_RAW;
+        std::memcpy(out.data() + COMPRESSION_OVERHEAD, data.data(), data.size());
+        return data.size() + COMPRESSION_OVERHEAD;
+    }
+
+    size_t decompressPayload(const std::span<const uint8_t> data, const std::span<uint8_t> out) noexcept
+    {
+        if (data.size() <= COMPRESSION_OVERHEAD) return 0;
+
+        const auto payload = data.subspan(COMPRESSION_OVERHEAD);
+        switch (data[0])
+        {
+        case COMPRESSION_RAW:
+            if (payload.size() > out.size()) return 0;
+            std::memcpy(out.data(), payload.data(), payload.size());
+            return payload.size();
+
+        case COMPRESSION_LZ:
+            return lzDecompress(payload, out);
+
+        default:
+            return 0;
+        }
+    }
+} // namespace net
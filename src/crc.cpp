@@ -0,0 +1,153 @@
+#include "net/crc.h"
+
+#include <algorithm>
+#include <array>
+
+#ifdef ESP_PLATFORM
+#include "esp_rom_crc.h"
+#endif
+
+namespace net
+{
+    namespace
+    {
+        /**
+         * @brief Таблицы slice-by-8 для отражённого CRC разрядностью до 32 бит
+         * @details tables[0] - классическая побайтовая таблица, tables[k][i] - вклад байта i,
+         *          за которым следуют k нулевых байт. Таблицы строятся при компиляции и лежат во flash.
+         */
+        template <uint32_t POLY>
+        struct SliceTables
+        {
+            std::array<std::array<uint32_t, 256>, 8> tables{};
+
+            constexpr SliceTables() noexcept
+            {
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; bit++)
+                    {
+                        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
+                    }
+                    tables[0][i] = crc;
+                }
+
+                for (size_t k = 1; k < tables.size(); k++)
+                {
+                    for (size_t i = 0; i < 256; i++)
+                    {
+                        const uint32_t prev = tables[k - 1][i];
+                        tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+                    }
+                }
+            }
+        };
+
+        constexpr SliceTables<0xEDB88320> CRC32_TABLES; ///< Отражённый полином 0x04C11DB7
+        constexpr SliceTables<0x8408> CRC16_TABLES;     ///< Отражённый полином 0x1021
+
+        /**
+         * @brief Чтение 32-битного слова little-endian без требований к выравниванию
+         */
+        uint32_t loadLe32(const uint8_t* data) noexcept
+        {
+            return static_cast<uint32_t>(data[0]) |
+                static_cast<uint32_t>(data[1]) << 8 |
+                static_cast<uint32_t>(data[2]) << 16 |
+                static_cast<uint32_t>(data[3]) << 24;
+        }
+
+        /**
+         * @brief Обновление отражённого CRC (без начальной и конечной инверсии)
+         */
+        template <uint32_t POLY>
+        uint32_t sliceBy8(const SliceTables<POLY>& slice, uint32_t crc, std::span<const uint8_t> data) noexcept
+        {
+            const auto& t = slice.tables;
+            const uint8_t* ptr = data.data();
+            size_t len = data.size();
+
+            while (len >= 8)
+            {
+                const uint32_t low = loadLe32(ptr) ^ crc;
+                const uint32_t high = loadLe32(ptr + 4);
+                crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+                    t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+                ptr += 8;
+                len -= 8;
+            }
+
+            while (len-- > 0)
+            {
+                crc = (crc >> 8) ^ t[0][(crc ^ *ptr++) & 0xFF];
+            }
+            return crc;
+        }
+
+        void storeLe(uint8_t* out, const uint32_t value, const size_t size) noexcept
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                out[i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+        }
+
+        uint32_t computeIntegrity(const Integrity integrity, const std::span<const uint8_t> data) noexcept
+        {
+            return integrity == Integrity::CRC32 ? crc32(data) : crc16(data);
+        }
+    } // namespace
+
+    uint32_t crc32Table(const std::span<const uint8_t> data, const uint32_t crc) noexcept
+    {
+        return ~sliceBy8(CRC32_TABLES, ~crc, data);
+    }
+
+    uint16_t crc16Table(const std::span<const uint8_t> data, const uint16_t crc) noexcept
+    {
+        return static_cast<uint16_t>(~sliceBy8(CRC16_TABLES, static_cast<uint16_t>(~crc), data));
+    }
+
+    uint32_t crc32(const std::span<const uint8_t> data, const uint32_t crc) noexcept
+    {
+#ifdef ESP_PLATFORM
+        // Табличная реализация ПЗУ не занимает flash и не вытесняет кэш
+        return esp_rom_crc32_le(crc, data.data(), data.size());
+#else
+        return crc32Table(data, crc);
+#endif
+    }
+
+    uint16_t crc16(const std::span<const uint8_t> data, const uint16_t crc) noexcept
+    {
+#ifdef ESP_PLATFORM
+        return esp_rom_crc16_le(crc, data.data(), data.size());
+#else
+        return crc16Table(data, crc);
+#endif
+    }
+
+    size_t appendIntegrity(const Integrity integrity, const std::span<uint8_t> buffer, const size_t size) noexcept
+    {
+        const size_t trailer = integritySize(integrity);
+        if (size + trailer > buffer.size()) return 0;
+        if (trailer == 0) return size;
+
+        storeLe(buffer.data() + size, computeIntegrity(integrity, buffer.first(size)), trailer);
+        return size + trailer;
+    }
+
+    size_t verifyIntegrity(const Integrity integrity, const std::span<const uint8_t> frame) noexcept
+    {
+        const size_t trailer = integritySize(integrity);
+        if (frame.size() <= trailer) return 0;
+
+        const size_t size = frame.size() - trailer;
+        if (trailer == 0) return size;
+
+        uint8_t expected[MAX_INTEGRITY_SIZE];
+        storeLe(expected, computeIntegrity(integrity, frame.first(size)), trailer);
+        return std::equal(expected, expected + trailer, frame.begin() + size) ? size : 0;
+    }
+} // namespace net
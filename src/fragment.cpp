@@ -0,0 +1,61 @@
+#include "net/fragment.h"
+
+#include <algorithm>
+
+namespace net
+{
+    size_t writeFragment(const Packet& packet, const size_t offset, const uint8_t index,
+                         const std::span<uint8_t> out) noexcept
+    {
+        if (out.size() <= FragmentHeader::SIZE || offset >= packet.size) return 0;
+
+        const size_t len = std::min<size_t>(packet.size - offset, out.size() - FragmentHeader::SIZE);
+
+        uint8_t header = index & FragmentHeader::INDEX_MASK;
+        if (offset == 0) header |= FragmentHeader::FIRST;
+        if (offset + len == packet.size) header |= FragmentHeader::LAST;
+
+        out[0] = header;
+        std::memcpy(out.data() + FragmentHeader::SIZE, packet.buffer.data() + offset, len);
+        return len;
+    }
+
+    Reassembler::Result Reassembler::push(const std::span<const uint8_t> data) noexcept
+    {
+        if (data.size() < FragmentHeader::SIZE) return Result::ERROR;
+
+        const uint8_t header = data[0];
+        const uint8_t index = header & FragmentHeader::INDEX_MASK;
+        const auto payload = data.subspan(FragmentHeader::SIZE);
+
+        // Первый фрагмент всегда начинает новый пакет, незавершённый отбрасывается
+        if (header & FragmentHeader::FIRST)
+        {
+            mPacket.size = 0;
+            mNextIndex = 0;
+            mActive = true;
+        }
+
+        if (!mActive || index != mNextIndex || mPacket.size + payload.size() > MAX_MTU)
+        {
+            reset();
+            return Result::ERROR;
+        }
+
+        std::memcpy(mPacket.buffer.data() + mPacket.size, payload.data(), payload.size());
+        mPacket.size = static_cast<uint16_t>(mPacket.size + payload.size());
+        mNextIndex = (mNextIndex + 1) & FragmentHeader::INDEX_MASK;
+
+        if (!(header & FragmentHeader::LAST)) return Result::INCOMPLETE;
+
+        mActive = false;
+        return mPacket.size > 0 ? Result::COMPLETE : Result::ERROR;
+    }
+
+    void Reassembler::reset() noexcept
+    {
+        mPacket.size = 0;
+        mNextIndex = 0;
+        mActive = false;
+    }
+} // namespace net
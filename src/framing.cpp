@@ -0,0 +1,103 @@
+#include "net/framing.h"
+
+#include <cstring>
+
+namespace net
+{
+    size_t cobsEncode(const std::span<const uint8_t> data, const std::span<uint8_t> out) noexcept
+    {
+        if (out.size() < cobsMaxEncodedSize(data.size())) return 0;
+
+        size_t codeIndex = 0;
+        size_t pos = 1;
+        uint8_t code = 1;
+
+        for (const uint8_t byte : data)
+        {
+            if (byte != COBS_DELIMITER)
+            {
+                out[pos++] = byte;
+                if (++code != 0xFF) continue;
+            }
+
+            // Блок завершён нулевым байтом или достиг максимальной длины
+            out[codeIndex] = code;
+            codeIndex = pos++;
+            code = 1;
+        }
+
+        out[codeIndex] = code;
+        return pos;
+    }
+
+    size_t cobsDecode(const std::span<const uint8_t> data, const std::span<uint8_t> out) noexcept
+    {
+        size_t in = 0;
+        size_t pos = 0;
+
+        while (in < data.size())
+        {
+            const uint8_t code = data[in++];
+            const size_t len = code - 1;
+            if (code == COBS_DELIMITER || in + len > data.size() || pos + len > out.size()) return 0;
+
+            // Выходной индекс не обгоняет входной, поэтому декодирование на месте безопасно
+            std::memmove(out.data() + pos, data.data() + in, len);
+            pos += len;
+            in += len;
+
+            if (code != 0xFF && in < data.size())
+            {
+                if (pos >= out.size()) return 0;
+                out[pos++] = COBS_DELIMITER;
+            }
+        }
+        return pos;
+    }
+
+    void StreamCodec::setFraming(const Framing framing) noexcept
+    {
+        mFraming = framing;
+        mDecoder.reset();
+    }
+
+    std::span<const uint8_t> StreamCodec::encode(const Packet& packet) noexcept
+    {
+        if (mFraming == Framing::RAW) return {packet.buffer.data(), packet.size};
+
+        std::memcpy(mPlain.data(), packet.buffer.data(), packet.size);
+        const size_t size = appendIntegrity(mIntegrity, mPlain, packet.size);
+
+        // Кадр COBS завершается разделителем, по которому приёмник находит границу пакета
+        const size_t encoded = cobsEncode(std::span(mPlain.data(), size), mEncoded);
+        mEncoded[encoded] = COBS_DELIMITER;
+        return {mEncoded.data(), encoded + 1};
+    }
+
+    void FrameDecoder::reset() noexcept
+    {
+        mSize = 0;
+        mOverflow = false;
+    }
+
+    std::span<const uint8_t> FrameDecoder::complete() noexcept
+    {
+        // Подряд идущие разделители не образуют кадра
+        if (mSize == 0 && !mOverflow) return {};
+
+        size_t size = 0;
+        if (!mOverflow)
+        {
+            size = cobsDecode(std::span(mBuffer.data(), mSize), mBuffer);
+        }
+
+        if (size == 0 || size > MAX_FRAME_SIZE)
+        {
+            mErrors++;
+            size = 0;
+        }
+
+        reset();
+        return {mBuffer.data(), size};
+    }
+} // namespace net
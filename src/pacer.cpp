@@ -0,0 +1,61 @@
+#include "net/pacer.h"
+
+#include <algorithm>
+
+namespace net
+{
+    Pacer::Pacer(const PacingPolicy& policy) noexcept
+    {
+        setPolicy(policy);
+    }
+
+    void Pacer::setPolicy(const PacingPolicy& policy) noexcept
+    {
+        std::lock_guard lock(mMutex);
+        mPolicy = policy;
+        mTokens = static_cast<int64_t>(std::max<uint32_t>(policy.burst, 1)) * SCALE;
+        mLastRefill = 0;
+    }
+
+    PacingPolicy Pacer::policy() const noexcept
+    {
+        std::lock_guard lock(mMutex);
+        return mPolicy;
+    }
+
+    int64_t Pacer::delayUs(const int64_t now) noexcept
+    {
+        std::lock_guard lock(mMutex);
+        if (mPolicy.isUnpaced()) return 0;
+
+        refill(now);
+        if (mTokens > 0) return 0;
+
+        // Время, за которое баланс станет положительным
+        return -mTokens / mPolicy.rate + 1;
+    }
+
+    void Pacer::consume(const size_t bytes, const int64_t now) noexcept
+    {
+        std::lock_guard lock(mMutex);
+        if (mPolicy.isUnpaced()) return;
+
+        refill(now);
+        const int64_t cost = mPolicy.unit == PacingPolicy::Unit::BYTES ? static_cast<int64_t>(bytes) : 1;
+        mTokens -= cost * SCALE;
+    }
+
+    void Pacer::refill(const int64_t now) noexcept
+    {
+        if (mLastRefill == 0 || now <= mLastRefill)
+        {
+            mLastRefill = std::max(mLastRefill, now);
+            return;
+        }
+
+        // Прирост в миллионных долях токена: мкс * токенов/с
+        const int64_t capacity = static_cast<int64_t>(std::max<uint32_t>(mPolicy.burst, 1)) * SCALE;
+        mTokens = std::min(capacity, mTokens + (now - mLastRefill) * mPolicy.rate);
+        mLastRefill = now;
+    }
+} // namespace net
@@ -0,0 +1,281 @@
+#include "net/packet_pool.h"
+
+#include <utility>
+
+namespace net
+{
+    namespace
+    {
+        constexpr uint32_t RESERVED_SHIFT = 16;     ///< Сдвиг размера резерва в его состоянии
+        constexpr uint32_t USED_MASK = 0xFFFF;      ///< Маска счётчика выделенных ячеек резерва
+
+        constexpr uint32_t reservedOf(const uint32_t state) noexcept { return state >> RESERVED_SHIFT; }
+        constexpr uint32_t usedOf(const uint32_t state) noexcept { return state & USED_MASK; }
+    } // namespace
+
+    PacketRef::PacketRef(const PacketRef& other) noexcept : mSlot(other.mSlot)
+    {
+        if (mSlot) mSlot->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PacketRef::PacketRef(PacketRef&& other) noexcept : mSlot(std::exchange(other.mSlot, nullptr))
+    {
+    }
+
+    PacketRef& PacketRef::operator=(const PacketRef& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (other.mSlot) other.mSlot->refs.fetch_add(1, std::memory_order_relaxed);
+            reset();
+            mSlot = other.mSlot;
+        }
+        return *this;
+    }
+
+    PacketRef& PacketRef::operator=(PacketRef&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            mSlot = std::exchange(other.mSlot, nullptr);
+        }
+        return *this;
+    }
+
+    PacketRef::~PacketRef()
+    {
+        reset();
+    }
+
+    uint16_t PacketRef::useCount() const noexcept
+    {
+        return mSlot ? mSlot->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+    uint8_t PacketRef::attempts() const noexcept
+    {
+        return mSlot ? mSlot->attempts : 0;
+    }
+
+    void PacketRef::setAttempts(const uint8_t attempts) const noexcept
+    {
+        if (mSlot) mSlot->attempts = attempts;
+    }
+
+    uint32_t PacketRef::enqueueTime() const noexcept
+    {
+        return mSlot ? mSlot->enqueueTime : 0;
+    }
+
+    void PacketRef::setEnqueueTime(const uint32_t time) const noexcept
+    {
+        if (mSlot) mSlot->enqueueTime = time;
+    }
+
+    uint32_t PacketRef::deadline() const noexcept
+    {
+        return mSlot ? mSlot->deadline : 0;
+    }
+
+    void PacketRef::setDeadline(const uint32_t deadline) const noexcept
+    {
+        if (mSlot) mSlot->deadline = deadline;
+    }
+
+    bool PacketRef::isExpired(const uint32_t now) const noexcept
+    {
+        // Разность со знаком корректна при переполнении 32-битного времени
+        return mSlot && mSlot->deadline != 0 && static_cast<int32_t>(now - mSlot->deadline) >= 0;
+    }
+
+    CompletionId PacketRef::completion() const noexcept
+    {
+        return mSlot ? mSlot->completion : 0;
+    }
+
+    void PacketRef::setCompletion(const CompletionId id) const noexcept
+    {
+        if (mSlot) mSlot->completion = id;
+    }
+
+    void PacketRef::reset() noexcept
+    {
+        if (!mSlot) return;
+
+        if (mSlot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            PacketPool::instance().release(mSlot);
+        }
+        mSlot = nullptr;
+    }
+
+    PacketSlot* PacketRef::release() noexcept
+    {
+        return std::exchange(mSlot, nullptr);
+    }
+
+    PacketRef PacketRef::adopt(PacketSlot* slot) noexcept
+    {
+        return PacketRef(slot);
+    }
+
+    PacketPool::PacketPool() noexcept
+    {
+        for (auto& slot : mSlots)
+        {
+            (void)mFree.push(&slot);
+        }
+    }
+
+    PacketPool& PacketPool::instance() noexcept
+    {
+        static PacketPool pool;
+        return pool;
+    }
+
+    PacketPool::ReservationId PacketPool::reserve(const size_t count) noexcept
+    {
+        if (count == 0 || count > CAPACITY) return 0;
+
+        // Ячейки резерва изымаются из общей части сразу, поэтому выделение из резерва не может не удаться
+        size_t shared = mShared.load(std::memory_order_relaxed);
+        do
+        {
+            if (shared < count) return 0;
+        } while (!mShared.compare_exchange_weak(shared, shared - count, std::memory_order_relaxed));
+
+        // Запись свободна, когда резерв снят и все его ячейки возвращены
+        const uint32_t state = static_cast<uint32_t>(count) << RESERVED_SHIFT;
+        for (size_t i = 0; i < mReservations.size(); i++)
+        {
+            uint32_t expected = 0;
+            if (mReservations[i].compare_exchange_strong(expected, state, std::memory_order_acq_rel))
+            {
+                return static_cast<ReservationId>(i + 1);
+            }
+        }
+
+        mShared.fetch_add(count, std::memory_order_relaxed);
+        return 0;
+    }
+
+    void PacketPool::unreserve(const ReservationId id) noexcept
+    {
+        if (id == 0 || id > mReservations.size()) return;
+
+        ReservationState& reservation = mReservations[id - 1];
+        uint32_t state = reservation.load(std::memory_order_relaxed);
+        while (!reservation.compare_exchange_weak(state, usedOf(state), std::memory_order_acq_rel))
+        {
+        }
+
+        // Неизрасходованная часть резерва возвращается в общую часть, выделенные ячейки - при освобождении
+        if (usedOf(state) < reservedOf(state))
+        {
+            mShared.fetch_add(reservedOf(state) - usedOf(state), std::memory_order_relaxed);
+        }
+    }
+
+    PacketRef PacketPool::acquire(const ReservationId reservation) noexcept
+    {
+        if (reservation > mReservations.size() || !take(reservation)) return {};
+
+        // Учёт гарантирует наличие свободной ячейки: освобождение возвращает её в очередь раньше учёта
+        PacketSlot* slot = nullptr;
+        if (!mFree.pop(slot))
+        {
+            give(reservation);
+            return {};
+        }
+        slot->reservation = reservation;
+
+        // Буфер не обнуляем: данные за пределами size считаются недействительными
+        slot->packet.id = 0;
+        slot->packet.size = 0;
+        slot->attempts = 0;
+        slot->enqueueTime = 0;
+        slot->deadline = 0;
+        slot->completion = 0;
+        slot->refs.store(1, std::memory_order_relaxed);
+        return PacketRef(slot);
+    }
+
+    PacketRef PacketPool::acquire(const Packet& packet, const ReservationId reservation) noexcept
+    {
+        if (packet.size > MAX_MTU) return {};
+
+        PacketRef ref = acquire(reservation);
+        if (ref)
+        {
+            ref->id = packet.id;
+            ref->size = packet.size;
+            std::memcpy(ref->buffer.data(), packet.buffer.data(), packet.size);
+        }
+        return ref;
+    }
+
+    size_t PacketPool::available() const noexcept
+    {
+        return mFree.size();
+    }
+
+    size_t PacketPool::shared() const noexcept
+    {
+        return mShared.load(std::memory_order_relaxed);
+    }
+
+    void PacketPool::release(PacketSlot* slot) noexcept
+    {
+        // Пакет удалён без отправки (очистка очереди, остановка транспорта)
+        if (const CompletionId id = std::exchange(slot->completion, 0); id != 0)
+        {
+            CompletionPool::instance().complete(id, ESP_ERR_INVALID_STATE);
+            CompletionPool::instance().release(id);
+        }
+
+        // Ячеек в пуле ровно CAPACITY, поэтому место в очереди свободных есть всегда
+        const ReservationId reservation = slot->reservation;
+        (void)mFree.push(slot);
+        give(reservation);
+    }
+
+    bool PacketPool::take(const ReservationId reservation) noexcept
+    {
+        if (reservation == 0) return takeShared();
+
+        ReservationState& state = mReservations[reservation - 1];
+        uint32_t current = state.load(std::memory_order_relaxed);
+        while (true)
+        {
+            // Сверх резерва ячейка занимается из общей части; при гонке она возвращается и попытка повторяется
+            const bool reserved = usedOf(current) < reservedOf(current);
+            if (!reserved && !takeShared()) return false;
+            if (state.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel)) return true;
+            if (!reserved) mShared.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void PacketPool::give(const ReservationId reservation) noexcept
+    {
+        if (reservation == 0)
+        {
+            mShared.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Ячейка сверх резерва (или снятого резерва) возвращается в общую часть
+        const uint32_t previous = mReservations[reservation - 1].fetch_sub(1, std::memory_order_acq_rel);
+        if (usedOf(previous) > reservedOf(previous)) mShared.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool PacketPool::takeShared() noexcept
+    {
+        size_t shared = mShared.load(std::memory_order_relaxed);
+        do
+        {
+            if (shared == 0) return false;
+        } while (!mShared.compare_exchange_weak(shared, shared - 1, std::memory_order_relaxed));
+        return true;
+    }
+} // namespace net
@@ -0,0 +1,475 @@
+#include "net/reliable.h"
+
+#include <esp_random.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace net
+{
+    namespace
+    {
+        constexpr uint8_t WINDOW_MASK = ReliablePolicy::MAX_WINDOW - 1;
+
+        static_assert((ReliablePolicy::MAX_WINDOW & WINDOW_MASK) == 0, "Window size must be a power of two");
+        static_assert(ReliablePolicy::MAX_WINDOW <= 16, "SACK bitmap holds 16 frames");
+    }
+
+    ReliableSession::ReliableSession() noexcept
+    {
+        reset();
+    }
+
+    void ReliableSession::setPolicy(const ReliablePolicy& policy) noexcept
+    {
+        {
+            std::lock_guard lock(mTxMutex);
+            mPolicy = policy;
+            mPolicy.window = std::clamp<uint8_t>(mPolicy.window, 1, ReliablePolicy::MAX_WINDOW);
+            mPolicy.minRtoUs = std::max<uint32_t>(mPolicy.minRtoUs, 1);
+            mPolicy.maxRtoUs = std::max(mPolicy.maxRtoUs, mPolicy.minRtoUs);
+        }
+        reset();
+    }
+
+    ReliablePolicy ReliableSession::policy() const noexcept
+    {
+        std::lock_guard lock(mTxMutex);
+        return mPolicy;
+    }
+
+    void ReliableSession::reset() noexcept
+    {
+        {
+            std::lock_guard lock(mTxMutex);
+            for (TxEntry& entry : mTx) entry = {};
+            mBase = 0;
+            mNextSeq = 0;
+            mEpoch = static_cast<uint8_t>(esp_random());
+            mSync = true;
+            mSrtt = 0;
+            mRttVar = 0;
+            mRto = std::clamp<int64_t>(mPolicy.initialRtoUs, mPolicy.minRtoUs, mPolicy.maxRtoUs);
+        }
+
+        std::lock_guard lock(mRxMutex);
+        for (PacketRef& ref : mRx) ref.reset();
+        mExpected = 0;
+        mRxEpoch = 0;
+        mRxSynced = false;
+        mPeerId = 0;
+        mAckPending.store(false, std::memory_order_relaxed);
+    }
+
+    std::optional<ReliableSession::FrameType> ReliableSession::frameType(const Packet& frame) noexcept
+    {
+        if (frame.size == 0) return std::nullopt;
+
+        switch (static_cast<FrameType>(frame.buffer[0]))
+        {
+            case FrameType::DATA:
+                if (frame.size >= DATA_HEADER) return FrameType::DATA;
+                break;
+            case FrameType::DATA_SYNC:
+                if (frame.size >= SYNC_HEADER) return FrameType::DATA_SYNC;
+                break;
+            case FrameType::ACK:
+                if (frame.size == ACK_SIZE) return FrameType::ACK;
+                break;
+        }
+        return std::nullopt;
+    }
+
+    bool ReliableSession::canSend() const noexcept
+    {
+        std::lock_guard lock(mTxMutex);
+        return static_cast<uint8_t>(mNextSeq - mBase) < mPolicy.window;
+    }
+
+    PacketRef ReliableSession::wrap(PacketRef& payload, const int64_t now) noexcept
+    {
+        std::lock_guard lock(mTxMutex);
+        if (static_cast<uint8_t>(mNextSeq - mBase) >= mPolicy.window) return {};
+
+        const size_t header = mSync ? SYNC_HEADER : DATA_HEADER;
+        if (payload->size + header > MAX_MTU) return {};
+
+        // Заголовок пишется в ячейку, поэтому разделяемая ячейка копируется
+        PacketRef frame;
+        if (payload.useCount() == 1)
+        {
+            frame = std::move(payload);
+        }
+        else
+        {
+            frame = PacketPool::instance().acquire(*payload);
+            if (!frame) return {};
+
+            frame.setEnqueueTime(payload.enqueueTime());
+            frame.setDeadline(payload.deadline());
+            frame.setCompletion(payload.completion());
+            payload.setCompletion(0);
+            payload.reset();
+        }
+
+        const uint8_t seq = mNextSeq++;
+        std::memmove(frame->buffer.data() + header, frame->buffer.data(), frame->size);
+        frame->buffer[0] = static_cast<uint8_t>(mSync ? FrameType::DATA_SYNC : FrameType::DATA);
+        frame->buffer[1] = seq;
+        if (mSync)
+        {
+            frame->buffer[2] = mEpoch;
+            frame->buffer[3] = mBase;
+        }
+        frame->size = static_cast<uint16_t>(frame->size + header);
+
+        TxEntry& entry = mTx[seq & WINDOW_MASK];
+        entry.frame = frame;
+        entry.sentAt = now;
+        entry.deadline = now + mRto;
+        entry.transmissions = 1;
+        entry.sacked = false;
+        return frame;
+    }
+
+    PacketRef ReliableSession::retransmission(const int64_t now) noexcept
+    {
+        std::lock_guard lock(mTxMutex);
+
+        const uint8_t inFlight = mNextSeq - mBase;
+        bool oldest = true;
+        for (uint8_t i = 0; i < inFlight; i++)
+        {
+            TxEntry& entry = mTx[(mBase + i) & WINDOW_MASK];
+            if (entry.sacked) continue;
+
+            // Истечение таймера старейшего кадра - одно событие для всего окна (RFC 6298, 5.5):
+            // отсрочка удваивается один раз, остальные кадры передаются с уже удвоенным таймером
+            const bool backoff = std::exchange(oldest, false);
+            if (now < entry.deadline || exhausted(entry)) continue;
+
+            if (backoff) mRto = std::min<int64_t>(mRto * 2, mPolicy.maxRtoUs);
+            entry.transmissions++;
+            entry.sentAt = now;
+            entry.deadline = now + mRto;
+            return entry.frame;
+        }
+        return {};
+    }
+
+    size_t ReliableSession::abandon(const int64_t now, const ResolveFunction& resolve)
+    {
+        std::array<PacketRef, ReliablePolicy::MAX_WINDOW> frames;
+        std::array<bool, ReliablePolicy::MAX_WINDOW> delivered{};
+        size_t count = 0;
+
+        {
+            std::lock_guard lock(mTxMutex);
+
+            const uint8_t inFlight = mNextSeq - mBase;
+            TxEntry& base = mTx[mBase & WINDOW_MASK];
+            if (inFlight == 0 || now < base.deadline || !exhausted(base)) return 0;
+
+            // Отказ только от начала окна: исчерпанные кадры и выборочно подтверждённые между ними
+            uint8_t dropped = 1;
+            while (dropped < inFlight)
+            {
+                const TxEntry& entry = mTx[(mBase + dropped) & WINDOW_MASK];
+                if (!entry.sacked && (now < entry.deadline || !exhausted(entry))) break;
+                dropped++;
+            }
+
+            // Остальные кадры продолжают окно в новой эпохе. Все они становятся DATA_SYNC с новым
+            // началом окна, чтобы любой из них сдвинул получателя за брошенные номера,
+            // а повтор кадра старой эпохи не вернул его назад. Первый передаётся сразу
+            for (uint8_t i = dropped; i < inFlight; i++)
+            {
+                TxEntry& entry = mTx[(mBase + i) & WINDOW_MASK];
+                if (!entry.sacked && !own(entry.frame))
+                {
+                    // Пул исчерпан: отказ откладывается на таймер, а не на каждый цикл
+                    base.deadline = now + mRto;
+                    return 0;
+                }
+            }
+
+            const uint8_t epoch = mEpoch + 1;
+            const uint8_t next = mBase + dropped;
+            bool first = true;
+            for (uint8_t i = dropped; i < inFlight; i++)
+            {
+                TxEntry& entry = mTx[(mBase + i) & WINDOW_MASK];
+                if (entry.sacked) continue;
+
+                resync(*entry.frame, epoch, next);
+                if (std::exchange(first, false)) entry.deadline = now;
+            }
+
+            for (uint8_t i = 0; i < dropped; i++)
+            {
+                TxEntry& entry = mTx[(mBase + i) & WINDOW_MASK];
+                delivered[count] = entry.sacked;
+                frames[count++] = std::move(entry.frame);
+                entry = {};
+            }
+
+            mBase = static_cast<uint8_t>(mBase + dropped);
+            mEpoch = epoch;
+            mSync = true;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!delivered[i]) unwrap(frames[i]);
+            resolve(frames[i], delivered[i]);
+        }
+        return count;
+    }
+
+    int64_t ReliableSession::timeoutUs(const int64_t now) const noexcept
+    {
+        std::lock_guard lock(mTxMutex);
+
+        int64_t timeout = -1;
+        const uint8_t inFlight = mNextSeq - mBase;
+        for (uint8_t i = 0; i < inFlight; i++)
+        {
+            const TxEntry& entry = mTx[(mBase + i) & WINDOW_MASK];
+
+            // Исчерпанный кадр ждёт подтверждения или отказа от старейшего кадра
+            if (entry.sacked || (i > 0 && exhausted(entry))) continue;
+
+            const int64_t delay = std::max<int64_t>(entry.deadline - now, 0);
+            if (timeout < 0 || delay < timeout) timeout = delay;
+        }
+        return timeout;
+    }
+
+    size_t ReliableSession::onAck(const Packet& frame, const int64_t now, const ResolveFunction& resolve)
+    {
+        if (frameType(frame) != FrameType::ACK) return 0;
+
+        const uint8_t epoch = frame.buffer[1];
+        const uint8_t expected = frame.buffer[2];
+        const uint16_t bitmap = static_cast<uint16_t>(frame.buffer[3] | frame.buffer[4] << 8);
+
+        std::array<PacketRef, ReliablePolicy::MAX_WINDOW> frames;
+        size_t count = 0;
+
+        {
+            std::lock_guard lock(mTxMutex);
+
+            // Подтверждение прошлой эпохи или номер за пределами окна
+            const uint8_t inFlight = mNextSeq - mBase;
+            const uint8_t acked = expected - mBase;
+            if (epoch != mEpoch || acked > inFlight) return 0;
+
+            // Получатель принял DATA_SYNC текущей эпохи
+            mSync = false;
+
+            for (uint8_t i = 0; i < acked; i++)
+            {
+                TxEntry& entry = mTx[(mBase + i) & WINDOW_MASK];
+
+                // Алгоритм Карна: время повторно переданных кадров неоднозначно
+                if (entry.transmissions == 1) sampleRtt(now - entry.sentAt);
+                frames[count++] = std::move(entry.frame);
+                entry = {};
+            }
+            mBase = expected;
+
+            for (uint8_t i = 0; i < ReliablePolicy::MAX_WINDOW; i++)
+            {
+                const uint8_t offset = static_cast<uint8_t>(i + 1);
+                if ((bitmap & 1u << i) && offset < inFlight - acked)
+                {
+                    mTx[(mBase + offset) & WINDOW_MASK].sacked = true;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            resolve(frames[i], true);
+        }
+        return count;
+    }
+
+    uint32_t ReliableSession::smoothedRttUs() const noexcept
+    {
+        std::lock_guard lock(mTxMutex);
+        return static_cast<uint32_t>(mSrtt);
+    }
+
+    bool ReliableSession::onData(const Packet& frame, const std::function<void(const Packet& payload)>& deliver)
+    {
+        const std::optional<FrameType> type = frameType(frame);
+        if (type != FrameType::DATA && type != FrameType::DATA_SYNC) return false;
+
+        const bool sync = type == FrameType::DATA_SYNC;
+        const size_t header = sync ? SYNC_HEADER : DATA_HEADER;
+        const uint8_t seq = frame.buffer[1];
+
+        // Выдача под мьютексом сохраняет порядок при приёме из нескольких задач
+        std::lock_guard lock(mRxMutex);
+
+        if (sync && (!mRxSynced || frame.buffer[2] != mRxEpoch))
+        {
+            // Отправитель отказался от кадров до base: выдаём принятые раньше него.
+            // Начало окна позади ожидаемого означает потерю подтверждений: кадры уже выданы
+            const uint8_t base = frame.buffer[3];
+            const uint8_t ahead = base - mExpected;
+            if (!mRxSynced || ahead <= ReliablePolicy::MAX_WINDOW)
+            {
+                flushBefore(base, deliver);
+                mExpected = base;
+            }
+            mRxEpoch = frame.buffer[2];
+            mRxSynced = true;
+        }
+        if (!mRxSynced) return true;
+
+        mPeerId = frame.id;
+        mAckPending.store(true, std::memory_order_relaxed);
+
+        const uint8_t offset = seq - mExpected;
+        if (offset >= ReliablePolicy::MAX_WINDOW) return true; // Повтор: только подтверждение
+
+        PacketRef& slot = mRx[seq & WINDOW_MASK];
+        if (!slot) slot = strip(frame, header);
+        if (!slot) return true; // Пул исчерпан: кадр будет передан повторно
+
+        while (PacketRef& next = mRx[mExpected & WINDOW_MASK])
+        {
+            deliver(*next);
+            next.reset();
+            mExpected++;
+        }
+        return true;
+    }
+
+    PacketRef ReliableSession::takeAck() noexcept
+    {
+        if (!mAckPending.exchange(false, std::memory_order_relaxed)) return {};
+
+        // Без ячейки подтверждение пропускается: следующий кадр или повтор запросит его снова
+        PacketRef ack = PacketPool::instance().acquire();
+        if (!ack) return {};
+
+        std::lock_guard lock(mRxMutex);
+
+        uint16_t bitmap = 0;
+        for (uint8_t i = 0; i < ReliablePolicy::MAX_WINDOW - 1; i++)
+        {
+            if (mRx[(mExpected + 1 + i) & WINDOW_MASK]) bitmap |= static_cast<uint16_t>(1u << i);
+        }
+
+        ack->id = mPeerId;
+        ack->size = ACK_SIZE;
+        ack->buffer[0] = static_cast<uint8_t>(FrameType::ACK);
+        ack->buffer[1] = mRxEpoch;
+        ack->buffer[2] = mExpected;
+        ack->buffer[3] = static_cast<uint8_t>(bitmap);
+        ack->buffer[4] = static_cast<uint8_t>(bitmap >> 8);
+        return ack;
+    }
+
+    void ReliableSession::sampleRtt(const int64_t rttUs) noexcept
+    {
+        const int64_t rtt = std::max<int64_t>(rttUs, 1);
+        if (mSrtt == 0)
+        {
+            mSrtt = rtt;
+            mRttVar = rtt / 2;
+        }
+        else
+        {
+            mRttVar = (3 * mRttVar + std::abs(mSrtt - rtt)) / 4;
+            mSrtt = (7 * mSrtt + rtt) / 8;
+        }
+        mRto = std::clamp<int64_t>(mSrtt + 4 * mRttVar, mPolicy.minRtoUs, mPolicy.maxRtoUs);
+    }
+
+    bool ReliableSession::exhausted(const TxEntry& entry) const noexcept
+    {
+        return entry.transmissions > mPolicy.maxRetransmits;
+    }
+
+    void ReliableSession::flushBefore(const uint8_t seq, const std::function<void(const Packet& payload)>& deliver)
+    {
+        // Кадры с номером seq и дальше остаются в окне: отправитель продолжает их нумерацию
+        const uint8_t limit = mRxSynced ? static_cast<uint8_t>(seq - mExpected) : 0;
+        for (uint8_t i = 0; i < ReliablePolicy::MAX_WINDOW; i++)
+        {
+            PacketRef& ref = mRx[(mExpected + i) & WINDOW_MASK];
+            if (!ref || (i >= limit && limit < ReliablePolicy::MAX_WINDOW)) continue;
+
+            deliver(*ref);
+            ref.reset();
+        }
+    }
+
+    bool ReliableSession::own(PacketRef& frame) noexcept
+    {
+        // Заголовок переписывается в ячейке, поэтому разделяемая ячейка копируется
+        if (frame.useCount() == 1) return true;
+
+        PacketRef copy = PacketPool::instance().acquire(*frame);
+        if (!copy) return false;
+
+        copy.setEnqueueTime(frame.enqueueTime());
+        copy.setDeadline(frame.deadline());
+        copy.setCompletion(frame.completion());
+        frame.setCompletion(0);
+        frame = std::move(copy);
+        return true;
+    }
+
+    void ReliableSession::resync(Packet& frame, const uint8_t epoch, const uint8_t base) noexcept
+    {
+        if (frameType(frame) == FrameType::DATA)
+        {
+            // Место под эпоху и начало окна зарезервировано проверкой размера при отправке (MAX_OVERHEAD)
+            std::memmove(frame.buffer.data() + SYNC_HEADER, frame.buffer.data() + DATA_HEADER,
+                         frame.size - DATA_HEADER);
+            frame.buffer[0] = static_cast<uint8_t>(FrameType::DATA_SYNC);
+            frame.size = static_cast<uint16_t>(frame.size + SYNC_HEADER - DATA_HEADER);
+        }
+        frame.buffer[2] = epoch;
+        frame.buffer[3] = base;
+    }
+
+    PacketRef ReliableSession::strip(const Packet& frame, const size_t header) noexcept
+    {
+        PacketRef ref = PacketPool::instance().acquire();
+        if (!ref) return {};
+
+        ref->id = frame.id;
+        ref->size = static_cast<uint16_t>(frame.size - header);
+        std::memcpy(ref->buffer.data(), frame.buffer.data() + header, ref->size);
+        return ref;
+    }
+
+    void ReliableSession::unwrap(PacketRef& frame) noexcept
+    {
+        const size_t header = frameType(*frame) == FrameType::DATA_SYNC ? SYNC_HEADER : DATA_HEADER;
+
+        if (frame.useCount() == 1)
+        {
+            frame->size = static_cast<uint16_t>(frame->size - header);
+            std::memmove(frame->buffer.data(), frame->buffer.data() + header, frame->size);
+            return;
+        }
+
+        // Ячейку ещё держит драйвер: данные копируются, ожидание завершения переносится в копию
+        if (PacketRef copy = strip(*frame, header))
+        {
+            copy.setEnqueueTime(frame.enqueueTime());
+            copy.setCompletion(frame.completion());
+            frame.setCompletion(0);
+            frame = std::move(copy);
+        }
+    }
+} // namespace net
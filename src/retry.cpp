@@ -0,0 +1,21 @@
+#include "net/retry.h"
+
+#include <esp_random.h>
+
+#include <algorithm>
+
+namespace net
+{
+    int64_t RetryPolicy::delayUs(const uint8_t attempts) const noexcept
+    {
+        // Сдвиг ограничен, чтобы не переполнить 64 бита при большом счётчике попыток
+        const unsigned shift = std::min<unsigned>(attempts > 0 ? attempts - 1 : 0, 31);
+        const int64_t delay = std::min<int64_t>(static_cast<int64_t>(baseDelayUs) << shift, maxDelayUs);
+
+        // Разброс разводит во времени повторы нескольких транспортов, упёршихся в общий ресурс
+        const int64_t spread = delay * std::min<uint8_t>(jitterPercent, 100) / 100;
+        if (spread == 0) return delay;
+
+        return delay - static_cast<int64_t>(esp_random() % static_cast<uint32_t>(spread + 1));
+    }
+} // namespace net
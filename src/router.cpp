@@ -0,0 +1,167 @@
+#include "net/router.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include <algorithm>
+
+namespace net
+{
+    namespace
+    {
+        constexpr auto RELAXED = std::memory_order_relaxed;
+    }
+
+    bool Route::setPrefix(const std::span<const uint8_t> bytes) noexcept
+    {
+        if (bytes.size() > MAX_PREFIX) return false;
+
+        std::copy(bytes.begin(), bytes.end(), prefix.begin());
+        prefixSize = static_cast<uint8_t>(bytes.size());
+        return true;
+    }
+
+    bool Route::matches(const Transport& from, const Packet& packet) const noexcept
+    {
+        if (&from != source) return false;
+        if (matchId && packet.id != *matchId) return false;
+
+        return packet.size >= prefixSize &&
+            std::equal(prefix.begin(), prefix.begin() + prefixSize, packet.buffer.begin());
+    }
+
+    Router::~Router()
+    {
+        std::array<Transport*, MAX_SOURCES> sources{};
+        {
+            std::lock_guard lock(mMutex);
+            sources = mSources;
+            mSources.fill(nullptr);
+        }
+
+        // setForwarder() дожидается текущего вызова route(), после возврата обращений к this нет
+        for (Transport* source : sources)
+        {
+            if (source) (void)source->setForwarder(nullptr);
+        }
+    }
+
+    esp_err_t Router::attach(Transport& transport)
+    {
+        {
+            std::lock_guard lock(mMutex);
+
+            if (std::find(mSources.begin(), mSources.end(), &transport) != mSources.end()) return ESP_OK;
+
+            const auto free = std::find(mSources.begin(), mSources.end(), nullptr);
+            if (free == mSources.end())
+            {
+                ESP_LOGE(TAG, "Too many source transports (max %zu)", MAX_SOURCES);
+                return ESP_ERR_NO_MEM;
+            }
+            *free = &transport;
+        }
+
+        // Без мьютекса маршрутизатора: задача приёма может ждать его внутри route(), удерживая обработчик
+        return transport.setForwarder([this, &transport](const Packet& packet)
+        {
+            return route(transport, packet);
+        });
+    }
+
+    esp_err_t Router::detach(Transport& transport)
+    {
+        {
+            std::lock_guard lock(mMutex);
+
+            const auto source = std::find(mSources.begin(), mSources.end(), &transport);
+            if (source == mSources.end()) return ESP_OK;
+            *source = nullptr;
+        }
+        return transport.setForwarder(nullptr);
+    }
+
+    std::optional<size_t> Router::addRoute(const Route& route)
+    {
+        if (!route.source || !route.destination || route.prefixSize > Route::MAX_PREFIX)
+        {
+            ESP_LOGE(TAG, "Invalid route");
+            return std::nullopt;
+        }
+
+        std::lock_guard lock(mMutex);
+        for (size_t id = 0; id < MAX_ROUTES; id++)
+        {
+            Entry& entry = mRoutes[id];
+            if (entry.active) continue;
+
+            entry.route = route;
+            entry.limiter.setPolicy(route.rateLimit);
+            entry.forwarded.store(0, RELAXED);
+            entry.bytes.store(0, RELAXED);
+            entry.rateLimited.store(0, RELAXED);
+            entry.rejected.store(0, RELAXED);
+            entry.active = true;
+            return id;
+        }
+
+        ESP_LOGE(TAG, "Route table full (max %zu)", MAX_ROUTES);
+        return std::nullopt;
+    }
+
+    esp_err_t Router::removeRoute(const size_t id)
+    {
+        std::lock_guard lock(mMutex);
+        if (id >= MAX_ROUTES || !mRoutes[id].active) return ESP_ERR_NOT_FOUND;
+
+        mRoutes[id].active = false;
+        return ESP_OK;
+    }
+
+    RouteStats Router::getStats(const size_t id) const noexcept
+    {
+        if (id >= MAX_ROUTES) return {};
+
+        const Entry& entry = mRoutes[id];
+        return {
+            .forwarded = entry.forwarded.load(RELAXED),
+            .bytes = entry.bytes.load(RELAXED),
+            .rateLimited = entry.rateLimited.load(RELAXED),
+            .rejected = entry.rejected.load(RELAXED)
+        };
+    }
+
+    bool Router::route(const Transport& from, const Packet& packet)
+    {
+        const int64_t now = esp_timer_get_time();
+        bool consumed = false;
+
+        std::lock_guard lock(mMutex);
+        for (Entry& entry : mRoutes)
+        {
+            if (!entry.active || !entry.route.matches(from, packet)) continue;
+            consumed |= entry.route.consume;
+
+            if (entry.limiter.delayUs(now) > 0)
+            {
+                entry.rateLimited.fetch_add(1, RELAXED);
+                continue;
+            }
+
+            // Каждый получатель пишет в ячейку время постановки и срок отправки, поэтому ячейка своя
+            PacketRef ref = PacketPool::instance().acquire(packet);
+            if (ref && entry.route.targetId) ref->id = *entry.route.targetId;
+
+            if (!ref || entry.route.destination->send(std::move(ref), entry.route.priority) != ESP_OK)
+            {
+                entry.rejected.fetch_add(1, RELAXED);
+                continue;
+            }
+
+            entry.limiter.consume(packet.size, now);
+            entry.forwarded.fetch_add(1, RELAXED);
+            entry.bytes.fetch_add(packet.size, RELAXED);
+        }
+        return consumed;
+    }
+} // namespace net
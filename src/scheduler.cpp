@@ -0,0 +1,52 @@
+#include "net/scheduler.h"
+
+#include <algorithm>
+
+namespace net
+{
+    void PriorityScheduler::setPolicy(const SchedulingPolicy& policy) noexcept
+    {
+        std::lock_guard lock(mMutex);
+        mPolicy = policy;
+        mCredits.fill(0);
+    }
+
+    SchedulingPolicy PriorityScheduler::policy() const noexcept
+    {
+        std::lock_guard lock(mMutex);
+        return mPolicy;
+    }
+
+    std::optional<Priority> PriorityScheduler::next(const std::array<bool, PRIORITY_COUNT>& pending) noexcept
+    {
+        if (std::ranges::none_of(pending, [](const bool value) { return value; })) return std::nullopt;
+
+        std::lock_guard lock(mMutex);
+
+        if (mPolicy.mode == SchedulingPolicy::Mode::STRICT)
+        {
+            const auto it = std::ranges::find(pending, true);
+            return static_cast<Priority>(std::distance(pending.begin(), it));
+        }
+
+        // Взвешенный обход: при исчерпании кредитов всех непустых классов начинается новый раунд
+        for (int round = 0; round < 2; round++)
+        {
+            for (size_t i = 0; i < PRIORITY_COUNT; i++)
+            {
+                if (pending[i] && mCredits[i] > 0)
+                {
+                    mCredits[i]--;
+                    return static_cast<Priority>(i);
+                }
+            }
+
+            for (size_t i = 0; i < PRIORITY_COUNT; i++)
+            {
+                // Нулевой вес трактуется как минимальный, чтобы класс не голодал
+                mCredits[i] = std::max<uint16_t>(mPolicy.weights[i], 1);
+            }
+        }
+        return std::nullopt;
+    }
+} // namespace net
@@ -0,0 +1,200 @@
+#include "net/send_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <new>
+
+namespace net
+{
+    HandleQueue::HandleQueue(const size_t depth) noexcept :
+        mDepth(std::clamp<size_t>(depth, 1, MAX_SIZE))
+    {
+    }
+
+    HandleQueue::~HandleQueue()
+    {
+        clear();
+    }
+
+    bool HandleQueue::isValid() const noexcept
+    {
+        return true;
+    }
+
+    bool HandleQueue::push(PacketRef& packet)
+    {
+        if (mQueue.size() >= mDepth) return false;
+
+        PacketSlot* slot = packet.release();
+        if (!mQueue.push(slot))
+        {
+            // Возвращаем владение вызывающему
+            packet = PacketRef::adopt(slot);
+            return false;
+        }
+        return true;
+    }
+
+    PacketRef HandleQueue::pop()
+    {
+        if (PacketSlot* slot = nullptr; mQueue.pop(slot))
+        {
+            return PacketRef::adopt(slot);
+        }
+        return {};
+    }
+
+    size_t HandleQueue::size() const
+    {
+        return mQueue.size();
+    }
+
+    size_t HandleQueue::clear()
+    {
+        size_t count = 0;
+        while (pop())
+        {
+            count++;
+        }
+        return count;
+    }
+
+    RecordQueue::RecordQueue(const size_t capacity) :
+        mBuffer(new(std::nothrow) uint8_t[capacity]),
+        mCapacity(mBuffer ? capacity : 0)
+    {
+    }
+
+    RecordQueue::~RecordQueue()
+    {
+        // Ожидающие асинхронные отправки завершаются с ESP_ERR_INVALID_STATE
+        clear();
+    }
+
+    bool RecordQueue::isValid() const noexcept
+    {
+        return mBuffer != nullptr;
+    }
+
+    bool RecordQueue::push(PacketRef& packet)
+    {
+        if (!packet) return false;
+
+        const RecordHeader header = {
+            .id = packet->id,
+            .size = packet->size,
+            .attempts = static_cast<uint16_t>(std::min<uint8_t>(packet.attempts(), 0x3F)),
+            .time = packet.enqueueTime(),
+            .deadline = packet.deadline(),
+            .completion = packet.completion()
+        };
+        const size_t recordSize = sizeof(header) + header.size;
+
+        {
+            std::lock_guard lock(mMutex);
+            if (mCapacity - mUsed < recordSize) return false;
+
+            const size_t tail = (mHead + mUsed) % mCapacity;
+            write(tail, &header, sizeof(header));
+            write((tail + sizeof(header)) % mCapacity, packet->buffer.data(), header.size);
+            mUsed += recordSize;
+            mCount++;
+        }
+
+        // Данные скопированы в буфер - ячейка пула больше не нужна, завершение переходит в запись
+        packet.setCompletion(0);
+        packet.reset();
+        return true;
+    }
+
+    PacketRef RecordQueue::pop()
+    {
+        std::lock_guard lock(mMutex);
+        if (mCount == 0) return {};
+
+        // Если пул исчерпан, запись остаётся в очереди до следующей попытки
+        PacketRef packet = PacketPool::instance().acquire();
+        if (!packet) return {};
+
+        RecordHeader header{};
+        read(mHead, &header, sizeof(header));
+        read((mHead + sizeof(header)) % mCapacity, packet->buffer.data(), header.size);
+        packet->id = header.id;
+        packet->size = header.size;
+        packet.setAttempts(header.attempts);
+        packet.setEnqueueTime(header.time);
+        packet.setDeadline(header.deadline);
+        packet.setCompletion(header.completion);
+
+        const size_t recordSize = sizeof(header) + header.size;
+        mHead = (mHead + recordSize) % mCapacity;
+        mUsed -= recordSize;
+        mCount--;
+        return packet;
+    }
+
+    size_t RecordQueue::size() const
+    {
+        std::lock_guard lock(mMutex);
+        return mCount;
+    }
+
+    size_t RecordQueue::clear()
+    {
+        std::array<CompletionId, CompletionPool::CAPACITY> completions{};
+        size_t completionCount = 0;
+        size_t count = 0;
+
+        {
+            std::lock_guard lock(mMutex);
+
+            // Ячейки завершения собираются под блокировкой, а callback вызываются после неё
+            size_t position = mHead;
+            for (size_t i = 0; i < mCount; i++)
+            {
+                RecordHeader header{};
+                read(position, &header, sizeof(header));
+                if (header.completion != 0 && completionCount < completions.size())
+                {
+                    completions[completionCount++] = header.completion;
+                }
+                position = (position + sizeof(header) + header.size) % mCapacity;
+            }
+
+            count = mCount;
+            mHead = 0;
+            mUsed = 0;
+            mCount = 0;
+        }
+
+        for (size_t i = 0; i < completionCount; i++)
+        {
+            CompletionPool::instance().complete(completions[i], ESP_ERR_INVALID_STATE);
+            CompletionPool::instance().release(completions[i]);
+        }
+        return count;
+    }
+
+    size_t RecordQueue::usedBytes() const
+    {
+        std::lock_guard lock(mMutex);
+        return mUsed;
+    }
+
+    void RecordQueue::write(const size_t offset, const void* data, const size_t len) noexcept
+    {
+        const auto* src = static_cast<const uint8_t*>(data);
+        const size_t first = std::min(len, mCapacity - offset);
+        std::memcpy(mBuffer.get() + offset, src, first);
+        std::memcpy(mBuffer.get(), src + first, len - first);
+    }
+
+    void RecordQueue::read(const size_t offset, void* data, const size_t len) const noexcept
+    {
+        auto* dst = static_cast<uint8_t*>(data);
+        const size_t first = std::min(len, mCapacity - offset);
+        std::memcpy(dst, mBuffer.get() + offset, first);
+        std::memcpy(dst + first, mBuffer.get(), len - first);
+    }
+} // namespace net
@@ -0,0 +1,102 @@
+#include "net/stats.h"
+
+#include <bit>
+
+namespace net
+{
+    namespace
+    {
+        constexpr auto RELAXED = std::memory_order_relaxed;
+    }
+
+    void StatsCollector::onSent(const size_t bytes, const uint32_t latencyUs) noexcept
+    {
+        mPacketsSent.fetch_add(1, RELAXED);
+        mBytesSent.fetch_add(static_cast<uint32_t>(bytes), RELAXED);
+        mLatency[latencyBucket(latencyUs)].fetch_add(1, RELAXED);
+    }
+
+    void StatsCollector::onReceived(const size_t bytes) noexcept
+    {
+        mPacketsReceived.fetch_add(1, RELAXED);
+        mBytesReceived.fetch_add(static_cast<uint32_t>(bytes), RELAXED);
+    }
+
+    void StatsCollector::onSendError(const esp_err_t err) noexcept
+    {
+        mSendErrors.fetch_add(1, RELAXED);
+        mLastError.store(err, RELAXED);
+    }
+
+    void StatsCollector::onRetry() noexcept
+    {
+        mRetries.fetch_add(1, RELAXED);
+    }
+
+    void StatsCollector::onDrop(const DropReason reason) noexcept
+    {
+        mDrops[static_cast<size_t>(reason)].fetch_add(1, RELAXED);
+    }
+
+    void StatsCollector::onQueueDepth(const size_t depth) noexcept
+    {
+        const auto value = static_cast<uint32_t>(depth);
+        uint32_t current = mQueueHighWater.load(RELAXED);
+
+        // Максимум обновляется только при превышении, поэтому CAS выполняется редко
+        while (value > current && !mQueueHighWater.compare_exchange_weak(current, value, RELAXED))
+        {
+        }
+    }
+
+    TransportStats StatsCollector::snapshot() const noexcept
+    {
+        TransportStats stats;
+        stats.packetsSent = mPacketsSent.load(RELAXED);
+        stats.bytesSent = mBytesSent.load(RELAXED);
+        stats.packetsReceived = mPacketsReceived.load(RELAXED);
+        stats.bytesReceived = mBytesReceived.load(RELAXED);
+        stats.retries = mRetries.load(RELAXED);
+        stats.sendErrors = mSendErrors.load(RELAXED);
+        stats.lastError = mLastError.load(RELAXED);
+        stats.queueHighWater = mQueueHighWater.load(RELAXED);
+
+        for (size_t i = 0; i < DROP_REASON_COUNT; i++)
+        {
+            stats.drops[i] = mDrops[i].load(RELAXED);
+        }
+        for (size_t i = 0; i < TransportStats::LATENCY_BUCKETS; i++)
+        {
+            stats.latency[i] = mLatency[i].load(RELAXED);
+        }
+        return stats;
+    }
+
+    void StatsCollector::reset() noexcept
+    {
+        mPacketsSent.store(0, RELAXED);
+        mBytesSent.store(0, RELAXED);
+        mPacketsReceived.store(0, RELAXED);
+        mBytesReceived.store(0, RELAXED);
+        mRetries.store(0, RELAXED);
+        mSendErrors.store(0, RELAXED);
+        mLastError.store(ESP_OK, RELAXED);
+        mQueueHighWater.store(0, RELAXED);
+
+        for (auto& counter : mDrops)
+        {
+            counter.store(0, RELAXED);
+        }
+        for (auto& counter : mLatency)
+        {
+            counter.store(0, RELAXED);
+        }
+    }
+
+    size_t StatsCollector::latencyBucket(const uint32_t latencyUs) noexcept
+    {
+        // Номер интервала - количество значащих бит задержки в единицах LATENCY_BASE_US
+        const auto bucket = static_cast<size_t>(std::bit_width(latencyUs / TransportStats::LATENCY_BASE_US));
+        return bucket < TransportStats::LATENCY_BUCKETS ? bucket : TransportStats::LATENCY_BUCKETS - 1;
+    }
+} // namespace net
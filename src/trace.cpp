@@ -0,0 +1,61 @@
+#include "net/trace.h"
+
+#include <esp_timer.h>
+
+#include <algorithm>
+#include <new>
+
+namespace net
+{
+    const char* traceEventName(const TraceEvent event) noexcept
+    {
+        switch (event)
+        {
+        case TraceEvent::ENQUEUE: return "enqueue";
+        case TraceEvent::DEQUEUE: return "dequeue";
+        case TraceEvent::SEND_START: return "send_start";
+        case TraceEvent::SEND_DONE: return "send_done";
+        case TraceEvent::RX: return "rx";
+        case TraceEvent::CALLBACK_DONE: return "callback_done";
+        }
+        return "unknown";
+    }
+
+    TraceRing::TraceRing(const size_t capacity) :
+        mRecords(new(std::nothrow) TraceRecord[capacity]),
+        mCapacity(mRecords ? capacity : 0)
+    {
+    }
+
+    uint32_t TraceRing::record(const TraceEvent event, const uint16_t id, const uint16_t size, const uint32_t tag,
+                               const uint8_t priority, const esp_err_t status) noexcept
+    {
+        const auto time = static_cast<uint32_t>(esp_timer_get_time());
+        if (mCapacity == 0) return time;
+
+        const uint32_t index = mNext.fetch_add(1, std::memory_order_relaxed);
+        mRecords[index % mCapacity] = {
+            .time = time,
+            .tag = tag,
+            .id = id,
+            .size = size,
+            .event = event,
+            .priority = priority,
+            .status = static_cast<int16_t>(std::clamp<esp_err_t>(status, INT16_MIN, INT16_MAX))
+        };
+        return time;
+    }
+
+    size_t TraceRing::read(const std::span<TraceRecord> out) const noexcept
+    {
+        const uint32_t next = mNext.load(std::memory_order_relaxed);
+        const size_t count = std::min({static_cast<size_t>(next), mCapacity, out.size()});
+
+        // Самые старые из сохранённых записей идут первыми
+        for (size_t i = 0; i < count; i++)
+        {
+            out[i] = mRecords[(next - count + i) % mCapacity];
+        }
+        return count;
+    }
+} // namespace net
@@ -1,41 +1,150 @@
 #include "net/transport.h"
 #include <esp_timer.h>
+#include <freertos/task.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <new>
 
 namespace net
 {
-    Transport::Transport(const char* tag) :
-        mThread("TRANSPORT", 4096, 19),
-        mSendQueue(MAX_QUEUE_SIZE),
+    namespace
+    {
+        /**
+         * @brief Перевод микросекунд в тики FreeRTOS с округлением вверх
+         */
+        TickType_t usToTicks(const int64_t us) noexcept
+        {
+            constexpr int64_t tickUs = 1000000 / configTICK_RATE_HZ;
+            return static_cast<TickType_t>((us + tickUs - 1) / tickUs);
+        }
+
+        /**
+         * @brief Остаток времени ожидания
+         * @param start Время начала ожидания (тики)
+         * @param timeout Полное время ожидания (portMAX_DELAY - без ограничения)
+         */
+        TickType_t remainingTicks(const TickType_t start, const TickType_t timeout) noexcept
+        {
+            if (timeout == portMAX_DELAY) return portMAX_DELAY;
+
+            const TickType_t elapsed = xTaskGetTickCount() - start;
+            return elapsed < timeout ? timeout - elapsed : 0;
+        }
+    }
+
+    Transport::Transport(const char* tag, const TransportConfig& config) :
+        mThread(config.threadName, config.stackSize, config.priority),
+        mPacer(config.pacing.value_or(PacingPolicy::packets(1000000 / SEND_INTERVAL_US))),
         mTag(tag)
     {
+        if (config.queueDepth == 0 || config.queueDepth > HandleQueue::MAX_SIZE)
+        {
+            ESP_LOGW(mTag, "Queue depth %zu out of range, clamped to 1..%zu", config.queueDepth, HandleQueue::MAX_SIZE);
+        }
+
         // Проверяем инициализацию всех критических компонентов
-        if (!mSendQueue.isValid())
+        for (auto& queue : mSendQueues)
         {
-            ESP_LOGE(mTag, "Failed to initialize send queue");
-            return;
+            queue = std::make_unique<HandleQueue>(config.queueDepth);
+            if (!queue->isValid())
+            {
+                ESP_LOGE(mTag, "Failed to initialize send queue");
+            }
+        }
+
+        mWakeSignal = xSemaphoreCreateBinary();
+        mEventSet = xQueueCreateSet(EVENT_SET_SIZE + 1);
+        if (!mWakeSignal || !mEventSet || xQueueAddToSet(mWakeSignal, mEventSet) != pdPASS)
+        {
+            ESP_LOGE(mTag, "Failed to initialize worker event set");
+        }
+
+        // Без сигнала send() с таймаутом не ждёт, а сразу возвращает ошибку
+        mSpaceSignal = xSemaphoreCreateBinary();
+        if (!mSpaceSignal)
+        {
+            ESP_LOGE(mTag, "Failed to create send queue space signal");
+        }
+
+        // Резерв гарантирует транспорту ячейки пула, даже если другой транспорт занял общую часть
+        mPoolReservation = PacketPool::instance().reserve(config.poolReserve);
+        if (config.poolReserve != 0 && mPoolReservation == 0)
+        {
+            ESP_LOGW(mTag, "Failed to reserve %zu packet pool slots, using shared slots only", config.poolReserve);
         }
     }
 
     Transport::~Transport()
     {
+        notifyWorker();
         mThread.stop();
-        std::lock_guard lock(mMutex);
+        clearQueue();
+
+        if (mEventSet)
+        {
+            if (mWakeSignal)
+            {
+                (void)xSemaphoreTake(mWakeSignal, 0);
+                xQueueRemoveFromSet(mWakeSignal, mEventSet);
+            }
+            vQueueDelete(mEventSet);
+        }
+        if (mWakeSignal) vSemaphoreDelete(mWakeSignal);
+        if (mSpaceSignal) vSemaphoreDelete(mSpaceSignal);
+        PacketPool::instance().unreserve(mPoolReservation);
+
+        std::lock_guard lock(mCallbackMutex);
         mDataCallback.reset();
     }
 
     void Transport::bind(std::unique_ptr<PacketCallback> dataCallback, PacketErrorFunction errorCallback)
     {
-        std::lock_guard lock(mMutex);
+        // Замена ждёт завершения текущего вызова в рабочем потоке
+        std::lock_guard lock(mCallbackMutex);
         mDataCallback = std::move(dataCallback);
         mErrorCallback = std::move(errorCallback);
     }
 
+    esp_err_t Transport::setForwarder(ForwardFunction forwarder)
+    {
+        // Замена ждёт завершения текущего вызова, поэтому владелец обработчика может быть удалён после возврата
+        std::lock_guard lock(mForwarderMutex);
+        mForwarder = std::move(forwarder);
+        return ESP_OK;
+    }
+
+    esp_err_t Transport::bindChannel(const uint8_t channel, std::unique_ptr<PacketCallback> callback)
+    {
+        if (channel >= MAX_CHANNELS)
+        {
+            ESP_LOGE(mTag, "Invalid channel %u", channel);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        std::lock_guard lock(mCallbackMutex);
+        mChannelCallbacks[channel] = std::move(callback);
+        return ESP_OK;
+    }
+
     bool Transport::start()
     {
+        if (!mEventSet)
+        {
+            ESP_LOGE(mTag, "Worker event set not initialized");
+            return false;
+        }
+
         auto loop = [&]()
         {
+            if (!mWorkerTask.load(std::memory_order_relaxed))
+            {
+                mWorkerTask.store(xTaskGetCurrentTaskHandle(), std::memory_order_relaxed);
+            }
+
+            processReceivedData(waitForEvents());
             processSendQueue();
-            processReceivedData();
+            mTransmitDelay = processTransmit();
             return esp32_c3::objects::Thread::LoopAction::CONTINUE;
         };
         return mThread.quickStart(loop);
@@ -43,57 +152,820 @@ namespace net
 
     void Transport::stop()
     {
-        (void)mSendQueue.reset();
+        clearQueue();
+        notifyWorker();
         mThread.stop();
+        mWorkerTask.store(nullptr, std::memory_order_relaxed);
+
+        // Ожидающие асинхронные отправки отменяются (пакеты в очередях - при их очистке)
+        completeBatch(ESP_ERR_INVALID_STATE);
+        mBatch.reset();
+        mCarry.reset();
+        mRetryPacket.reset();
+
+        // Кадры окна завершаются с ESP_ERR_INVALID_STATE при освобождении ячеек
+        mReliable.reset();
     }
 
-    esp_err_t Transport::send(const Packet& packet)
+    esp_err_t Transport::send(const Packet& packet, const Priority priority, const TickType_t timeout)
     {
-        std::lock_guard lock(mMutex);
-
         // Валидация параметров
         if (!isInitialized() || !packet.isValid())
         {
             ESP_LOGE(mTag, "Invalid send params: init=%d, len=%zu, max_mtu=%u",
-                     mIsInitialized, packet.size, MAX_MTU);
+                     mIsInitialized.load(), packet.size, MAX_MTU);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        // Ячейки пула освобождает рабочий поток после отправки
+        const TickType_t start = xTaskGetTickCount();
+        PacketRef ref = PacketPool::instance().acquire(packet, mPoolReservation);
+        while (!ref && waitForSpace(start, timeout))
+        {
+            ref = PacketPool::instance().acquire(packet, mPoolReservation);
+        }
+        if (!ref)
+        {
+            ESP_LOGW(mTag, "Packet pool exhausted");
+            mStats.onDrop(DropReason::REJECTED);
+            return ESP_ERR_NO_MEM;
+        }
+
+        return send(std::move(ref), priority, remainingTicks(start, timeout));
+    }
+
+    esp_err_t Transport::sendChannel(const uint8_t channel, const Packet& packet, const TickType_t timeout)
+    {
+        if (channel >= MAX_CHANNELS || !isInitialized() || !packet.isValid())
+        {
+            ESP_LOGE(mTag, "Invalid channel send params: channel=%u, init=%d, len=%u",
+                     channel, mIsInitialized.load(), packet.size);
             return ESP_ERR_INVALID_ARG;
         }
+        if (!mChannelsEnabled)
+        {
+            ESP_LOGE(mTag, "Channels are disabled");
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (packet.size + CHANNEL_HEADER_SIZE > MAX_MTU)
+        {
+            ESP_LOGE(mTag, "Packet of %u bytes exceeds MTU with channel header", packet.size);
+            mChannels.onRejected(channel);
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        const TickType_t start = xTaskGetTickCount();
+        PacketRef ref = PacketPool::instance().acquire(mPoolReservation);
+        while (!ref && waitForSpace(start, timeout))
+        {
+            ref = PacketPool::instance().acquire(mPoolReservation);
+        }
+        if (!ref)
+        {
+            ESP_LOGW(mTag, "Packet pool exhausted");
+            mStats.onDrop(DropReason::REJECTED);
+            mChannels.onRejected(channel);
+            return ESP_ERR_NO_MEM;
+        }
+
+        ref->id = packet.id;
+        ref->size = static_cast<uint16_t>(packet.size + CHANNEL_HEADER_SIZE);
+        ref->buffer[0] = channel;
+        std::copy_n(packet.buffer.begin(), packet.size, ref->buffer.begin() + CHANNEL_HEADER_SIZE);
+
+        const esp_err_t ret = send(std::move(ref), mChannels.priority(channel), remainingTicks(start, timeout));
+        if (ret == ESP_OK) mChannels.onQueued(channel, packet.size);
+        else mChannels.onRejected(channel);
+        return ret;
+    }
+
+    SendHandle Transport::sendAsync(const Packet& packet, CompletionFunction onComplete, const Priority priority)
+    {
+        SendHandle handle = CompletionPool::instance().acquire(std::move(onComplete));
+        if (handle.id() == 0)
+        {
+            ESP_LOGW(mTag, "Completion pool exhausted");
+            mStats.onDrop(DropReason::REJECTED);
+            return handle;
+        }
+
+        PacketRef ref = PacketPool::instance().acquire(packet, mPoolReservation);
+        if (!ref)
+        {
+            ESP_LOGW(mTag, "Packet pool exhausted");
+            mStats.onDrop(DropReason::REJECTED);
+            CompletionPool::instance().complete(handle.id(), ESP_ERR_NO_MEM);
+            return handle;
+        }
+
+        // Пакет удерживает свою ссылку на ячейку до завершения отправки
+        CompletionPool::instance().retain(handle.id());
+        ref.setCompletion(handle.id());
 
-        return mSendQueue.send(packet, 0) ? ESP_OK : ESP_ERR_INVALID_STATE;
+        // Ошибка постановки в очередь уже записана в ячейку завершения
+        (void)send(std::move(ref), priority);
+        return handle;
+    }
+
+    esp_err_t Transport::send(PacketRef packet, const Priority priority, const TickType_t timeout)
+    {
+        // Мьютекс не нужен: сжатие и объединение не меняются при запущенном потоке,
+        // а очереди и пул потокобезопасны сами по себе
+        if (!isInitialized() || !packet || !packet->isValid())
+        {
+            ESP_LOGE(mTag, "Invalid send params: init=%d, ref=%d", mIsInitialized.load(), static_cast<bool>(packet));
+            complete(packet, ESP_ERR_INVALID_ARG);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        if (mCompression != Compression::NONE)
+        {
+            // Исходный пакет может разделяться с другими транспортами, поэтому сжимается копия
+            PacketRef compressed = PacketPool::instance().acquire(mPoolReservation);
+            if (!compressed)
+            {
+                ESP_LOGW(mTag, "Packet pool exhausted");
+                mStats.onDrop(DropReason::REJECTED);
+                complete(packet, ESP_ERR_NO_MEM);
+                return ESP_ERR_NO_MEM;
+            }
+
+            const size_t size = compressPayload(std::span(packet->buffer.data(), packet->size), compressed->buffer);
+            if (size == 0)
+            {
+                ESP_LOGE(mTag, "Packet of %u bytes exceeds MTU with compression header", packet->size);
+                mStats.onDrop(DropReason::REJECTED);
+                complete(packet, ESP_ERR_INVALID_SIZE);
+                return ESP_ERR_INVALID_SIZE;
+            }
+
+            compressed->id = packet->id;
+            compressed->size = static_cast<uint16_t>(size);
+            compressed.setDeadline(packet.deadline());
+            compressed.setCompletion(packet.completion());
+            packet.setCompletion(0);
+            packet = std::move(compressed);
+        }
+
+        const size_t framed = (mCoalescing.enabled ? batchRecordSize(packet->size) : packet->size) +
+            (mReliableEnabled ? ReliableSession::MAX_OVERHEAD : 0);
+        if (framed > MAX_MTU)
+        {
+            ESP_LOGE(mTag, "Packet of %u bytes exceeds MTU with batch record and frame headers", packet->size);
+            mStats.onDrop(DropReason::REJECTED);
+            complete(packet, ESP_ERR_INVALID_SIZE);
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        const auto enqueueTime = static_cast<uint32_t>(esp_timer_get_time());
+        packet.setEnqueueTime(enqueueTime);
+
+        // Собственный срок пакета имеет приоритет над сроком жизни транспорта (0 зарезервирован за "без срока")
+        if (const uint32_t ttl = mPacketTtl.load(std::memory_order_relaxed); ttl != 0 && packet.deadline() == 0)
+        {
+            packet.setDeadline(std::max<uint32_t>(enqueueTime + ttl, 1));
+        }
+        trace(TraceEvent::ENQUEUE, *packet, enqueueTime, priority);
+
+        const TickType_t start = xTaskGetTickCount();
+        bool waited = false;
+        while (!queue(priority).push(packet))
+        {
+            if (!waitForSpace(start, timeout))
+            {
+                mStats.onDrop(DropReason::REJECTED);
+                complete(packet, ESP_ERR_INVALID_STATE);
+                return ESP_ERR_INVALID_STATE;
+            }
+            waited = true;
+        }
+
+        // Сигнал один на всех ожидающих: передаём его дальше, следующий отправитель проверит место сам
+        if (waited) xSemaphoreGive(mSpaceSignal);
+
+        const size_t depth = getQueueSize();
+        mStats.onQueueDepth(depth);
+        notifyWorker();
+
+        if (mWatermarkCallback && mHighWatermark != 0 && depth >= mHighWatermark && !mCongested.exchange(true))
+        {
+            mWatermarkCallback(true);
+        }
+        return ESP_OK;
     }
 
     void Transport::processSendQueue()
     {
-        if (mNextSendTime > esp_timer_get_time()) return;
+        if (mReliableEnabled) processReliable(esp_timer_get_time());
+
+        // Отправляем пакеты, пока их позволяет ограничитель скорости
+        while (sendDelayUs(esp_timer_get_time()) == 0)
+        {
+            Priority priority = Priority::INTERACTIVE;
+            PacketRef packet;
+            bool retransmission = false;
+
+            if (mReliableEnabled)
+            {
+                // Кадры с истёкшим таймером передаются раньше новых пакетов
+                packet = mReliable.retransmission(esp_timer_get_time());
+                retransmission = static_cast<bool>(packet);
+                if (!packet && mReliable.canSend()) packet = nextReliable(priority, esp_timer_get_time());
+            }
+            else
+            {
+                packet = mCoalescing.enabled ? nextBatch(priority) : nextPacket(priority);
+            }
+            if (!packet) break;
+
+            // Для объединённого пакета DEQUEUE записывается при добавлении каждого пакета в nextBatch()
+            if (!mCoalescing.enabled && !retransmission)
+            {
+                trace(TraceEvent::DEQUEUE, *packet, packet.enqueueTime(), priority);
+            }
+
+            trace(TraceEvent::SEND_START, *packet, packet.enqueueTime(), priority);
+            const esp_err_t ret = sendImpl(packet, priority);
+            trace(TraceEvent::SEND_DONE, *packet, packet.enqueueTime(), priority, ret);
+
+            // Неудачная попытка тоже расходует токены, чтобы поток не вращался вхолостую
+            mPacer.consume(packet->size, esp_timer_get_time());
+
+            if (ret != ESP_OK)
+            {
+                mStats.onSendError(ret);
+
+                // Кадр остаётся в окне и будет передан повторно по таймеру
+                if (mReliableEnabled)
+                {
+                    ESP_LOGW(mTag, "Frame send failed, waiting for retransmission: %s", esp_err_to_name(ret));
+                    break;
+                }
+
+                handleSendError(std::move(packet), ret, priority);
+                break;
+            }
+
+            if (retransmission)
+            {
+                mStats.onRetry();
+            }
+            else
+            {
+                mStats.onSent(packet->size, static_cast<uint32_t>(esp_timer_get_time()) - packet.enqueueTime());
+            }
+
+            // При надёжной доставке кадр завершается по подтверждению получателя
+            if (!mReliableEnabled)
+            {
+                if (mCoalescing.enabled) completeBatch(ESP_OK);
+                else complete(packet, ESP_OK);
+            }
+            ESP_LOGV(mTag, "Sent successfully");
+
+            // Ячейка пула отправленного пакета свободна
+            packet.reset();
+            if (mSpaceSignal) xSemaphoreGive(mSpaceSignal);
+        }
+    }
+
+    PacketRef Transport::nextPacket(Priority& priority)
+    {
+        while (true)
+        {
+            PacketRef packet;
 
-        if (Packet packet; mSendQueue.receive(packet, 0))
+            // Пакет, повторяемый на месте, отправляется раньше всех очередей
+            if (mRetryPacket)
+            {
+                priority = mRetryPriority;
+                packet = std::move(mRetryPacket);
+            }
+            else
+            {
+                std::array<bool, PRIORITY_COUNT> pending{};
+                for (size_t i = 0; i < PRIORITY_COUNT; i++)
+                {
+                    pending[i] = mSendQueues[i]->size() > 0;
+                }
+
+                bool stalled = false;
+                while (!packet)
+                {
+                    const auto next = mScheduler.next(pending);
+                    if (!next)
+                    {
+                        // Ячейку освобождает другая задача без пробуждения потока: повторяем после паузы
+                        if (stalled)
+                        {
+                            ESP_LOGW(mTag, "Packet pool exhausted");
+                            mRetryTime = esp_timer_get_time() + SEND_INTERVAL_US;
+                        }
+                        return {};
+                    }
+
+                    priority = *next;
+                    packet = queue(*next).pop();
+
+                    // Непустая очередь не выдала пакет (RecordQueue при исчерпанном пуле) - обслуживаем другие классы
+                    if (!packet)
+                    {
+                        pending[static_cast<size_t>(*next)] = false;
+                        stalled = true;
+                    }
+                }
+                onQueueSpace();
+            }
+
+            if (!packet || !packet.isExpired(static_cast<uint32_t>(esp_timer_get_time()))) return packet;
+
+            // Устаревший пакет отбрасывается без отправки и не занимает ограничитель скорости
+            ESP_LOGD(mTag, "Packet expired in queue, dropped");
+            mStats.onDrop(DropReason::EXPIRED);
+            trace(TraceEvent::DEQUEUE, *packet, packet.enqueueTime(), priority, ESP_ERR_TIMEOUT);
+            reportError(*packet, ESP_ERR_TIMEOUT);
+            complete(packet, ESP_ERR_TIMEOUT);
+        }
+    }
+
+    PacketRef Transport::nextReliable(Priority& priority, const int64_t now)
+    {
+        PacketRef payload = mCoalescing.enabled ? nextBatch(priority) : nextPacket(priority);
+        if (!payload) return {};
+
+        PacketRef frame = mReliable.wrap(payload, now);
+        if (!frame)
         {
-            if (const esp_err_t ret = sendImpl(packet); ret == ESP_OK)
+            // Разделяемый пакет не удалось скопировать: возвращаем его на место до освобождения пула
+            ESP_LOGW(mTag, "Packet pool exhausted");
+            mRetryTime = now + SEND_INTERVAL_US;
+
+            if (mCoalescing.enabled)
             {
-                mNextSendTime = esp_timer_get_time() + SEND_INTERVAL_US;
-                ESP_LOGV(mTag, "Sent successfully");
+                mBatch = std::move(payload);
+                mBatchPriority = priority;
+                mBatchDeadline = 0;
             }
             else
             {
-                handleSendError(packet, ret);
+                mRetryPacket = std::move(payload);
+                mRetryPriority = priority;
+            }
+            return {};
+        }
+
+        // Пакеты объединения не хранят ячейки завершения в кадре и завершаются при передаче в окно
+        if (mCoalescing.enabled) completeBatch(ESP_OK);
+        return frame;
+    }
+
+    void Transport::processReliable(const int64_t now)
+    {
+        // Подтверждение отправляется сразу, минуя очереди; токены расходуются, как у любого пакета
+        if (PacketRef ack = mReliable.takeAck())
+        {
+            const esp_err_t ret = sendImpl(ack, Priority::CONTROL);
+            mPacer.consume(ack->size, now);
+            if (ret != ESP_OK)
+            {
+                mStats.onSendError(ret);
+                ESP_LOGD(mTag, "Ack send failed: %s", esp_err_to_name(ret));
+            }
+        }
+
+        mReliable.abandon(now, [this](PacketRef& frame, const bool delivered)
+        {
+            if (delivered)
+            {
+                complete(frame, ESP_OK);
+                return;
+            }
+
+            ESP_LOGE(mTag, "Frame not acknowledged after %u retransmissions, dropped",
+                     mReliable.policy().maxRetransmits);
+            mStats.onDrop(DropReason::RETRY_EXHAUSTED);
+            reportError(*frame, ESP_ERR_TIMEOUT);
+            complete(frame, ESP_ERR_TIMEOUT);
+        });
+    }
+
+    PacketRef Transport::nextBatch(Priority& priority)
+    {
+        const int64_t now = esp_timer_get_time();
+        const size_t overhead = mReliableEnabled ? ReliableSession::MAX_OVERHEAD : 0;
+        const size_t limit = std::min<size_t>(getMtuSize(), MAX_MTU) - overhead;
+
+        // Переносим пакеты из очередей, пока они подходят к собираемому пакету
+        while (mCarry || (mCarry = nextPacket(mCarryPriority)))
+        {
+            if (!mBatch)
+            {
+                mBatch = PacketPool::instance().acquire(mPoolReservation);
+                if (!mBatch)
+                {
+                    ESP_LOGW(mTag, "Packet pool exhausted");
+                    mRetryTime = now + SEND_INTERVAL_US;
+                    return {};
+                }
+
+                mBatch->id = mCarry->id;
+                mBatch->size = 0;
+                mBatch.setEnqueueTime(mCarry.enqueueTime());
+                mBatchPriority = mCarryPriority;
+                mBatchDeadline = now + mCoalescing.flushDelayUs;
+            }
+            else if (mCarryPriority != mBatchPriority || mCarry->id != mBatch->id || mBatch.useCount() > 1)
+            {
+                // Пакет другого адресата или класса закрывает собираемый пакет
+                mBatchDeadline = now;
+                break;
+            }
+
+            // Ячейки завершения всех записей должны поместиться в список собираемого пакета
+            const CompletionId completion = mCarry.completion();
+            if (completion != 0 && mBatchCompletionCount == mBatchCompletions.size())
+            {
+                mBatchDeadline = now;
+                break;
+            }
+
+            // Первая запись помещается всегда (размер проверен в send()), даже если MTU канала меньше
+            if (!appendRecord(*mBatch, *mCarry, mBatch->size == 0 ? MAX_MTU - overhead : limit))
+            {
+                mBatchDeadline = now;
+                break;
+            }
+            trace(TraceEvent::DEQUEUE, *mCarry, mCarry.enqueueTime(), mCarryPriority);
+
+            if (completion != 0)
+            {
+                mBatchCompletions[mBatchCompletionCount++] = completion;
+                mCarry.setCompletion(0);
+            }
+            mCarry.reset();
+
+            if (mBatch->size + batchRecordSize(1) > limit) mBatchDeadline = now;
+        }
+
+        if (!mBatch || now < mBatchDeadline) return {};
+
+        priority = mBatchPriority;
+        return std::move(mBatch);
+    }
+
+    void Transport::complete(const PacketRef& packet, const esp_err_t result) noexcept
+    {
+        const CompletionId id = packet.completion();
+        if (id == 0) return;
+
+        packet.setCompletion(0);
+        CompletionPool::instance().complete(id, result);
+        CompletionPool::instance().release(id);
+    }
+
+    bool Transport::waitForSpace(const TickType_t start, const TickType_t timeout) const noexcept
+    {
+        const TickType_t remaining = remainingTicks(start, timeout);
+        return mSpaceSignal && remaining != 0 && xSemaphoreTake(mSpaceSignal, remaining) == pdTRUE;
+    }
+
+    void Transport::onQueueSpace()
+    {
+        if (mSpaceSignal) xSemaphoreGive(mSpaceSignal);
+
+        if (mWatermarkCallback && mCongested.load(std::memory_order_relaxed) &&
+            getQueueSize() <= mLowWatermark && mCongested.exchange(false))
+        {
+            mWatermarkCallback(false);
+        }
+    }
+
+    void Transport::completeBatch(const esp_err_t result) noexcept
+    {
+        for (size_t i = 0; i < mBatchCompletionCount; i++)
+        {
+            CompletionPool::instance().complete(mBatchCompletions[i], result);
+            CompletionPool::instance().release(mBatchCompletions[i]);
+        }
+        mBatchCompletionCount = 0;
+    }
+
+    QueueSetMemberHandle_t Transport::waitForEvents()
+    {
+        TickType_t timeout = std::min(receivePollInterval(), pdMS_TO_TICKS(IDLE_WAIT_MS));
+        const int64_t now = esp_timer_get_time();
+
+        // При заполненном окне надёжной доставки новые пакеты ждут подтверждения, а не отправки
+        const bool canSend = !mReliableEnabled || mReliable.canSend();
+
+        // При непустой очереди просыпаемся к моменту следующей отправки
+        if (canSend && (getQueueSize() > 0 || mCarry || mRetryPacket))
+        {
+            const int64_t delay = sendDelayUs(now);
+            timeout = delay <= 0 ? 0 : std::min(timeout, usToTicks(delay));
+        }
+
+        // Собираемый пакет отправляется по истечении ожидания попутных пакетов
+        if (canSend && mBatch)
+        {
+            const int64_t delay = std::max(sendDelayUs(now), mBatchDeadline - now);
+            timeout = delay <= 0 ? 0 : std::min(timeout, usToTicks(delay));
+        }
+
+        // Подтверждение отправляется без задержки, повторная передача - по таймеру окна
+        if (mReliableEnabled)
+        {
+            if (mReliable.ackPending())
+            {
+                timeout = 0;
+            }
+            else if (const int64_t rto = mReliable.timeoutUs(now); rto >= 0)
+            {
+                const int64_t delay = std::max(sendDelayUs(now), rto);
+                timeout = delay <= 0 ? 0 : std::min(timeout, usToTicks(delay));
+            }
+        }
+
+        // Транспорту требуется повторный вызов processTransmit()
+        if (mTransmitDelay >= 0)
+        {
+            timeout = std::min(timeout, usToTicks(mTransmitDelay));
+        }
+
+        // Выбранный член набора должен быть прочитан, остальные - нет (контракт набора очередей)
+        const QueueSetMemberHandle_t source = xQueueSelectFromSet(mEventSet, timeout);
+        if (source == mWakeSignal)
+        {
+            (void)xSemaphoreTake(mWakeSignal, 0);
+            return nullptr;
+        }
+        return source;
+    }
+
+    int64_t Transport::sendDelayUs(const int64_t now) noexcept
+    {
+        return std::max(mRetryTime - now, mPacer.delayUs(now));
+    }
+
+    void Transport::notifyWorker() const noexcept
+    {
+        if (mWakeSignal) xSemaphoreGive(mWakeSignal);
+    }
+
+    bool Transport::addEventSource(const QueueHandle_t queue) const noexcept
+    {
+        if (!mEventSet || !queue) return false;
+        return xQueueAddToSet(queue, mEventSet) == pdPASS;
+    }
+
+    void Transport::removeEventSource(const QueueHandle_t queue) const noexcept
+    {
+        if (!mEventSet || !queue) return;
+
+        // Удалить из набора можно только пустую очередь
+        (void)xQueueReset(queue);
+        xQueueRemoveFromSet(queue, mEventSet);
+    }
+
+    void Transport::handleSendError(PacketRef packet, const esp_err_t err, const Priority priority)
+    {
+        if (err == ESP_ERR_NOT_FINISHED)
+        {
+            // Очередь одного адресата заполнена: пауза и повтор задержали бы остальных адресатов
+            ESP_LOGD(mTag, "Peer queue full, packet dropped");
+            mStats.onDrop(DropReason::PEER_OVERFLOW);
+            reportError(*packet, ESP_ERR_NO_MEM);
+            if (mCoalescing.enabled) completeBatch(ESP_ERR_NO_MEM);
+            else complete(packet, ESP_ERR_NO_MEM);
+            return;
+        }
+
+        const RetryPolicy policy = getRetry();
+        const auto attempts = static_cast<uint8_t>(std::min<unsigned>(packet.attempts() + 1, RetryPolicy::MAX_ATTEMPTS));
+
+        if (!isTemporary(err) || !policy.canRetry(attempts))
+        {
+            ESP_LOGE(mTag, "Packet dropped after %u attempts: %s", attempts, esp_err_to_name(err));
+            mStats.onDrop(isTemporary(err) ? DropReason::RETRY_EXHAUSTED : DropReason::SEND_ERROR);
+            reportError(*packet, err);
+            if (mCoalescing.enabled) completeBatch(err);
+            else complete(packet, err);
+            return;
+        }
+
+        mStats.onRetry();
+
+        // Пауза распространяется на все классы: временная ошибка обычно означает перегрузку драйвера
+        const int64_t delay = policy.delayUs(attempts);
+        mRetryTime = esp_timer_get_time() + delay;
+        ESP_LOGW(mTag, "Temp error (attempt %u, retry in %lu us): %s",
+                 attempts, static_cast<unsigned long>(delay), esp_err_to_name(err));
+
+        // Счётчик хранится в ячейке пула, поэтому разделяемый пакет по возможности копируется
+        if (packet.useCount() > 1)
+        {
+            if (PacketRef copy = PacketPool::instance().acquire(*packet, mPoolReservation))
+            {
+                copy.setEnqueueTime(packet.enqueueTime());
+                copy.setDeadline(packet.deadline());
+                copy.setCompletion(packet.completion());
+                packet.setCompletion(0);
+                packet = std::move(copy);
             }
         }
+        packet.setAttempts(attempts);
+
+        if (mCoalescing.enabled)
+        {
+            // Объединённый пакет возвращается в сборку и отправляется первым
+            mBatch = std::move(packet);
+            mBatchPriority = priority;
+            mBatchDeadline = 0;
+            return;
+        }
+
+        if (policy.mode == RetryPolicy::Mode::IN_PLACE)
+        {
+            mRetryPacket = std::move(packet);
+            mRetryPriority = priority;
+            return;
+        }
+
+        // Возвращаем в конец очереди без копирования
+        if (!queue(priority).push(packet))
+        {
+            ESP_LOGE(mTag, "Send queue full, packet dropped");
+            mStats.onDrop(DropReason::REJECTED);
+            reportError(*packet, err);
+            complete(packet, err);
+        }
     }
 
-    void Transport::handleSendError(const Packet& packet, const esp_err_t err)
+    void Transport::reportError(const Packet& packet, const esp_err_t err)
     {
+        std::lock_guard lock(mCallbackMutex);
         if (mErrorCallback) mErrorCallback(packet, err);
+    }
+
+    esp_err_t Transport::enableTrace(const size_t capacity)
+    {
+        std::lock_guard lock(mMutex);
+
+        // Журнал пишется без блокировки, поэтому заменяется только при остановленном потоке
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(mTag, "Cannot change trace while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mTrace.reset();
+        if (capacity == 0) return ESP_OK;
+
+        auto trace = std::make_unique<TraceRing>(capacity);
+        if (!trace->isValid())
+        {
+            ESP_LOGE(mTag, "Failed to allocate trace of %zu records", capacity);
+            return ESP_ERR_NO_MEM;
+        }
+
+        mTrace = std::move(trace);
+        return ESP_OK;
+    }
+
+    size_t Transport::readTrace(const std::span<TraceRecord> out) const noexcept
+    {
+        return mTrace ? mTrace->read(out) : 0;
+    }
+
+    void Transport::dumpTrace() const
+    {
+        if (!mTrace) return;
+
+        const std::unique_ptr<TraceRecord[]> records(new(std::nothrow) TraceRecord[mTrace->capacity()]);
+        if (!records)
+        {
+            ESP_LOGE(mTag, "Not enough memory to dump trace");
+            return;
+        }
+
+        // Формат строк разбирает tools/trace_to_chrome.py
+        const size_t count = mTrace->read(std::span(records.get(), mTrace->capacity()));
+        for (size_t i = 0; i < count; i++)
+        {
+            const TraceRecord& record = records[i];
+            ESP_LOGI(mTag, "trace %" PRIu32 " %s id=%u size=%u prio=%u tag=%" PRIu32 " status=%d",
+                     record.time, traceEventName(record.event), record.id, record.size,
+                     record.priority, record.tag, record.status);
+        }
+    }
+
+    uint32_t Transport::trace(const TraceEvent event, const Packet& packet, const uint32_t tag,
+                              const Priority priority, const esp_err_t status) const noexcept
+    {
+        if (!mTrace) return 0;
+        return mTrace->record(event, packet.id, packet.size, tag, static_cast<uint8_t>(priority), status);
+    }
+
+    TransportStats Transport::getStats() const noexcept
+    {
+        return mStats.snapshot();
+    }
+
+    size_t Transport::getStackHighWaterMark() const noexcept
+    {
+        // В ESP-IDF запас стека возвращается в байтах
+        const TaskHandle_t task = mWorkerTask.load(std::memory_order_relaxed);
+        return task ? uxTaskGetStackHighWaterMark(task) : 0;
+    }
+
+    void Transport::resetStats() noexcept
+    {
+        mStats.reset();
+        mChannels.resetStats();
+    }
+
+    void Transport::setRetry(const RetryPolicy& policy)
+    {
+        std::lock_guard lock(mMutex);
+        mRetry = policy;
+    }
+
+    RetryPolicy Transport::getRetry() const
+    {
+        std::lock_guard lock(mMutex);
+        return mRetry;
+    }
 
-        if (isTemporary(err))
+    esp_err_t Transport::setQueueWatermarks(const size_t high, const size_t low, WatermarkFunction callback)
+    {
+        std::lock_guard lock(mMutex);
+
+        // send() читает пороги без блокировки
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
         {
-            ESP_LOGW(mTag, "Temp error (retry): %s", esp_err_to_name(err));
-            // Возвращаем обратно в очередь для повторной попытки
-            mSendQueue.send(packet, 0);
+            ESP_LOGE(mTag, "Cannot change queue watermarks while worker is running");
+            return ESP_ERR_INVALID_STATE;
         }
-        else
+        if (high != 0 && low >= high)
         {
-            ESP_LOGE(mTag, "Fatal error (dropped): %s", esp_err_to_name(err));
+            ESP_LOGE(mTag, "Invalid queue watermarks: high=%zu, low=%zu", high, low);
+            return ESP_ERR_INVALID_ARG;
         }
+
+        mHighWatermark = high;
+        mLowWatermark = low;
+        mWatermarkCallback = std::move(callback);
+        mCongested = false;
+        return ESP_OK;
+    }
+
+    bool Transport::isCongested() const noexcept
+    {
+        return mCongested.load(std::memory_order_relaxed);
+    }
+
+    void Transport::setPacketTtl(const uint32_t ttlUs) noexcept
+    {
+        mPacketTtl.store(ttlUs, std::memory_order_relaxed);
+    }
+
+    uint32_t Transport::getPacketTtl() const noexcept
+    {
+        return mPacketTtl.load(std::memory_order_relaxed);
+    }
+
+    esp_err_t Transport::setChannelsEnabled(const bool enabled)
+    {
+        std::lock_guard lock(mMutex);
+
+        // Получатель разбирает заголовок по текущему режиму
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(mTag, "Cannot change channel mode while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mChannelsEnabled = enabled;
+        return ESP_OK;
+    }
+
+    bool Transport::channelsEnabled() const
+    {
+        std::lock_guard lock(mMutex);
+        return mChannelsEnabled;
+    }
+
+    esp_err_t Transport::setChannelPriority(const uint8_t channel, const Priority priority) noexcept
+    {
+        if (channel >= MAX_CHANNELS) return ESP_ERR_INVALID_ARG;
+
+        mChannels.setPriority(channel, priority);
+        return ESP_OK;
+    }
+
+    ChannelStats Transport::getChannelStats(const uint8_t channel) const noexcept
+    {
+        return mChannels.stats(channel);
     }
 
     bool Transport::isInitialized() const noexcept
@@ -101,6 +973,218 @@ namespace net
         return mIsInitialized && mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING;
     }
 
+    void Transport::dispatchReceived(const Packet& packet)
+    {
+        if (!hasReceiver()) return;
+
+        // Время приёма связывает событие RX с возвратами из callback
+        const uint32_t rxTag = trace(TraceEvent::RX, packet, 0);
+
+        if (!mReliableEnabled)
+        {
+            dispatchPayload(packet, rxTag);
+            return;
+        }
+
+        const auto type = ReliableSession::frameType(packet);
+        if (type == ReliableSession::FrameType::ACK)
+        {
+            const size_t released = mReliable.onAck(packet, esp_timer_get_time(), [](PacketRef& frame, bool)
+            {
+                complete(frame, ESP_OK);
+            });
+
+            // Освободилось место в окне и ячейки пула
+            if (released > 0)
+            {
+                if (mSpaceSignal) xSemaphoreGive(mSpaceSignal);
+                notifyWorker();
+            }
+            return;
+        }
+
+        const bool valid = type && mReliable.onData(packet, [this, rxTag](const Packet& payload)
+        {
+            dispatchPayload(payload, rxTag);
+        });
+        if (!valid)
+        {
+            ESP_LOGW(mTag, "Malformed frame dropped, size %u", packet.size);
+            mStats.onDrop(DropReason::MALFORMED);
+            return;
+        }
+
+        if (mReliable.ackPending()) notifyWorker();
+    }
+
+    void Transport::dispatchPayload(const Packet& packet, const uint32_t rxTag)
+    {
+        if (!mCoalescing.enabled)
+        {
+            deliver(packet, rxTag);
+            return;
+        }
+
+        BatchReader reader(packet);
+        while (reader.next(mRxRecord))
+        {
+            deliver(mRxRecord, rxTag);
+        }
+
+        if (reader.failed())
+        {
+            ESP_LOGW(mTag, "Malformed batch truncated, size %u", packet.size);
+            mStats.onDrop(DropReason::MALFORMED);
+        }
+    }
+
+    void Transport::deliver(const Packet& packet, const uint32_t rxTag)
+    {
+        const Packet* payload = &packet;
+        Packet& plain = mRxPlain;
+
+        if (mCompression != Compression::NONE)
+        {
+            plain.id = packet.id;
+            const size_t size = decompressPayload(std::span(packet.buffer.data(), packet.size), plain.buffer);
+            if (size == 0)
+            {
+                ESP_LOGW(mTag, "Malformed compressed packet dropped, size %u", packet.size);
+                mStats.onDrop(DropReason::MALFORMED);
+                return;
+            }
+
+            plain.size = static_cast<uint16_t>(size);
+            payload = &plain;
+        }
+
+        mStats.onReceived(payload->size);
+
+        // Пересланный пакет не передаётся в callback данных, если правило его поглощает
+        {
+            std::lock_guard lock(mForwarderMutex);
+            if (mForwarder && mForwarder(*payload)) return;
+        }
+
+        // Callback вызываются под мьютексом: bind() и bindChannel() во время работы ждут завершения вызова
+        std::lock_guard lock(mCallbackMutex);
+        if (!mChannelsEnabled)
+        {
+            if (!mDataCallback) return;
+
+            mDataCallback->invoke(*payload, [this](const Packet& result)
+            {
+                send(result);
+            });
+            trace(TraceEvent::CALLBACK_DONE, *payload, rxTag);
+            return;
+        }
+
+        const uint8_t channel = payload->buffer[0];
+        if (payload->size <= CHANNEL_HEADER_SIZE || channel >= MAX_CHANNELS)
+        {
+            ESP_LOGW(mTag, "Malformed channel packet dropped, channel %u, size %u", channel, payload->size);
+            mStats.onDrop(DropReason::MALFORMED);
+            return;
+        }
+
+        // Заголовок снимается сдвигом данных в буфер распакованного пакета (для сжатого - на месте)
+        plain.id = payload->id;
+        plain.size = static_cast<uint16_t>(payload->size - CHANNEL_HEADER_SIZE);
+        std::copy_n(payload->buffer.begin() + CHANNEL_HEADER_SIZE, plain.size, plain.buffer.begin());
+        mChannels.onReceived(channel, plain.size);
+
+        PacketCallback* callback = mChannelCallbacks[channel] ? mChannelCallbacks[channel].get() : mDataCallback.get();
+        if (!callback) return;
+
+        callback->invoke(plain, [this, channel](const Packet& result)
+        {
+            sendChannel(channel, result);
+        });
+        trace(TraceEvent::CALLBACK_DONE, plain, rxTag);
+    }
+
+    esp_err_t Transport::setCompression(const Compression compression)
+    {
+        std::lock_guard lock(mMutex);
+
+        // Пакеты в очередях уже закодированы в текущем режиме
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(mTag, "Cannot change compression while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mCompression = compression;
+        return ESP_OK;
+    }
+
+    Compression Transport::getCompression() const
+    {
+        std::lock_guard lock(mMutex);
+        return mCompression;
+    }
+
+    esp_err_t Transport::setCoalescing(const CoalescingPolicy& policy)
+    {
+        std::lock_guard lock(mMutex);
+
+        // Получатель разбирает пакеты по текущей политике, смена на ходу исказит поток
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(mTag, "Cannot change coalescing while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mCoalescing = policy;
+        return ESP_OK;
+    }
+
+    CoalescingPolicy Transport::getCoalescing() const
+    {
+        std::lock_guard lock(mMutex);
+        return mCoalescing;
+    }
+
+    esp_err_t Transport::setReliable(const ReliablePolicy& policy)
+    {
+        std::lock_guard lock(mMutex);
+
+        // Получатель разбирает кадры по текущему режиму
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(mTag, "Cannot change reliable mode while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mReliable.setPolicy(policy);
+        mReliableEnabled = policy.enabled;
+        return ESP_OK;
+    }
+
+    ReliablePolicy Transport::getReliable() const
+    {
+        return mReliable.policy();
+    }
+
+    uint32_t Transport::getRttUs() const noexcept
+    {
+        return mReliable.smoothedRttUs();
+    }
+
+    bool Transport::hasReceiver() const noexcept
+    {
+        {
+            std::lock_guard lock(mForwarderMutex);
+            if (mForwarder) return true;
+        }
+
+        std::lock_guard lock(mCallbackMutex);
+        return mDataCallback || mReliableEnabled ||
+            std::any_of(mChannelCallbacks.begin(), mChannelCallbacks.end(),
+                        [](const auto& callback) { return callback != nullptr; });
+    }
+
     void Transport::setInitialized(const bool value)
     {
         mIsInitialized = value;
@@ -108,20 +1192,78 @@ namespace net
 
     size_t Transport::getQueueSize() const
     {
-        return mSendQueue.waiting();
+        size_t count = 0;
+        for (const auto& queue : mSendQueues)
+        {
+            count += queue->size();
+        }
+        return count;
+    }
+
+    size_t Transport::getQueueSize(const Priority priority) const
+    {
+        return queue(priority).size();
     }
 
     size_t Transport::clearQueue()
     {
         size_t count = 0;
-        Packet packet;
-        while (mSendQueue.receive(packet, 0))
+        for (const auto& queue : mSendQueues)
         {
-            count++;
+            count += queue->clear();
         }
+
+        if (count > 0) onQueueSpace();
         return count;
     }
 
+    esp_err_t Transport::setSendQueue(std::unique_ptr<SendQueue> queue, const Priority priority)
+    {
+        std::lock_guard lock(mMutex);
+
+        if (!queue || !queue->isValid())
+        {
+            ESP_LOGE(mTag, "Invalid send queue");
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        // Рабочий поток обращается к очереди без блокировки
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(mTag, "Cannot replace send queue while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mSendQueues[static_cast<size_t>(priority)] = std::move(queue);
+        return ESP_OK;
+    }
+
+    void Transport::setScheduling(const SchedulingPolicy& policy) noexcept
+    {
+        mScheduler.setPolicy(policy);
+    }
+
+    SchedulingPolicy Transport::getScheduling() const noexcept
+    {
+        return mScheduler.policy();
+    }
+
+    SendQueue& Transport::queue(const Priority priority) const noexcept
+    {
+        return *mSendQueues[static_cast<size_t>(priority)];
+    }
+
+    void Transport::setPacing(const PacingPolicy& policy) noexcept
+    {
+        mPacer.setPolicy(policy);
+        notifyWorker();
+    }
+
+    PacingPolicy Transport::getPacing() const noexcept
+    {
+        return mPacer.policy();
+    }
+
     bool Transport::isTemporary(const esp_err_t ret) noexcept
     {
         return ret == ESP_ERR_NO_MEM ||     // Нехватка памяти
@@ -7,8 +7,9 @@ namespace net
     Uart::Uart(const SerialType type,
                const uart_config_t& config,
                const std::optional<gpio_num_t> rxPin,
-               const std::optional<gpio_num_t> txPin) noexcept :
-        Transport(TAG),
+               const std::optional<gpio_num_t> txPin,
+               const TransportConfig& transportConfig) noexcept :
+        Transport(TAG, transportConfig),
         mType(type),
         mUartNum(type == SerialType::UART0 ? UART_NUM_0 : UART_NUM_1)
     {
@@ -31,21 +32,34 @@ namespace net
             }
         }
 
-        ret = uart_driver_install(mUartNum, MAX_MTU, MAX_MTU, 0, nullptr, 0);
+        ret = uart_driver_install(mUartNum, MAX_MTU, MAX_MTU, EVENT_QUEUE_SIZE, &mEventQueue, 0);
         if (ret != ESP_OK)
         {
             ESP_LOGE(TAG, "Failed to install UART%d driver: %s", mUartNum, esp_err_to_name(ret));
+            mEventQueue = nullptr;
             return;
         }
 
+        // Рабочий поток просыпается по событиям драйвера вместо блокирующего чтения
+        if (!addEventSource(mEventQueue))
+        {
+            ESP_LOGE(TAG, "Failed to register UART%d event queue", mUartNum);
+            return;
+        }
+
+        // Ограничиваем скорость пропускной способностью линии (8N1: 10 бит на байт), если она не задана явно
+        if (!transportConfig.pacing) setPacing(PacingPolicy::bytes(config.baud_rate / 10, MAX_MTU));
+
         setInitialized(true);
         ESP_LOGI(TAG, "UART%d initialized successfully", mUartNum);
     }
 
     Uart::~Uart()
     {
-        if (!isInitialized()) return;
+        stop();
+        if (!mEventQueue) return;
 
+        removeEventSource(mEventQueue);
         if (const esp_err_t ret = uart_driver_delete(mUartNum); ret != ESP_OK)
         {
             ESP_LOGE(TAG, "Failed to delete UART%d driver: %s", mUartNum, esp_err_to_name(ret));
@@ -54,7 +68,6 @@ namespace net
 
     uint32_t Uart::baudRate() const noexcept
     {
-        std::lock_guard lock(mMutex);
         if (!isInitialized()) return 0;
 
         uint32_t rate = 0;
@@ -73,7 +86,6 @@ namespace net
 
     size_t Uart::available() const noexcept
     {
-        std::lock_guard lock(mMutex);
         if (!isInitialized()) return 0;
 
         size_t avail = 0;
@@ -85,9 +97,10 @@ namespace net
         return avail;
     }
 
-    size_t Uart::read(std::span<uint8_t> buffer) const noexcept
+    size_t Uart::read(std::span<uint8_t> buffer, const TickType_t timeout) const noexcept
     {
-        std::lock_guard lock(mMutex);
+        // Драйвер потокобезопасен; отдельный мьютекс лишь не даёт двум читателям делить поток
+        std::lock_guard lock(mReadMutex);
         if (!isInitialized() || buffer.empty())
         {
             ESP_LOGW(TAG, "Invalid read parameters");
@@ -95,7 +108,7 @@ namespace net
         }
 
         ESP_LOGD(TAG, "Reading %zu bytes", buffer.size());
-        const int len = uart_read_bytes(mUartNum, buffer.data(), buffer.size(), pdMS_TO_TICKS(100));
+        const int len = uart_read_bytes(mUartNum, buffer.data(), buffer.size(), timeout);
         if (len < 0)
         {
             ESP_LOGE(TAG, "Failed to read bytes");
@@ -107,7 +120,6 @@ namespace net
 
     size_t Uart::write(const std::span<const uint8_t> data) const noexcept
     {
-        // std::lock_guard lock(mMutex);
         if (!isInitialized() || data.empty())
         {
             ESP_LOGE(TAG, "Invalid write parameters");
@@ -125,14 +137,59 @@ namespace net
         return static_cast<size_t>(len);
     }
 
-    esp_err_t Uart::sendImpl(Packet& packet)
+    esp_err_t Uart::setFraming(const Framing framing)
+    {
+        std::lock_guard lock(mMutex);
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(TAG, "Cannot change framing while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mCodec.setFraming(framing);
+        return ESP_OK;
+    }
+
+    Framing Uart::framing() const
+    {
+        std::lock_guard lock(mMutex);
+        return mCodec.framing();
+    }
+
+    esp_err_t Uart::setIntegrity(const Integrity integrity)
+    {
+        std::lock_guard lock(mMutex);
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(TAG, "Cannot change integrity check while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mCodec.setIntegrity(integrity);
+        return ESP_OK;
+    }
+
+    Integrity Uart::integrity() const
     {
-        ESP_LOGD(TAG, "Writing packet, size: %zu", packet.size);
-        const size_t written = write(std::span(packet.buffer.data(), packet.size));
+        std::lock_guard lock(mMutex);
+        return mCodec.integrity();
+    }
 
-        if (written != packet.size)
+    size_t Uart::frameErrors() const
+    {
+        std::lock_guard lock(mMutex);
+        return mCodec.errors();
+    }
+
+    esp_err_t Uart::sendImpl(const PacketRef& packet, Priority)
+    {
+        ESP_LOGD(TAG, "Writing packet, size: %zu", packet->size);
+        // Кодек используется только рабочим потоком, настройки при работе не меняются
+        const std::span<const uint8_t> data = mCodec.encode(*packet);
+        const size_t written = write(data);
+        if (written != data.size())
         {
-            ESP_LOGE(TAG, "Failed to write full packet: %zu/%zu bytes", written, packet.size);
+            ESP_LOGE(TAG, "Failed to write full packet: %zu/%zu bytes", written, data.size());
             return ESP_FAIL;
         }
 
@@ -140,19 +197,37 @@ namespace net
         return ESP_OK;
     }
 
-    void Uart::processReceivedData()
+    void Uart::processReceivedData(const QueueSetMemberHandle_t source)
     {
-        if (!mDataCallback || available() == 0) return;
+        uart_event_t event{};
+        if (!mEventQueue || source != mEventQueue || xQueueReceive(mEventQueue, &event, 0) != pdTRUE) return;
+
+        switch (event.type)
+        {
+        case UART_DATA:
+            break;
+
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            ESP_LOGW(TAG, "RX overflow (event %d), flushing input", event.type);
+            uart_flush_input(mUartNum);
+            return;
+
+        default:
+            ESP_LOGD(TAG, "Unhandled UART event: %d", event.type);
+            return;
+        }
 
-        Packet packet{};
-        packet.size = read(std::span<uint8_t>(packet.buffer));
+        if (!hasReceiver() || available() == 0) return;
 
-        if (packet.size > 0)
+        // Поток читается порциями до опустошения буфера драйвера; границы пакетов задаёт кодек
+        size_t len = 0;
+        while ((len = read(mChunk, 0)) > 0)
         {
-            ESP_LOGV(TAG, "Processing %zu bytes", packet.size);
-            mDataCallback->invoke(packet, [&](const Packet& result)
+            mCodec.decode(std::span(mChunk.data(), len), [&](const Packet& packet)
             {
-                send(result);
+                ESP_LOGV(TAG, "Processing %zu bytes", packet.size);
+                dispatchReceived(packet);
             });
         }
     }
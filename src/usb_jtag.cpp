@@ -5,7 +5,7 @@
 
 namespace net
 {
-    UsbJtag::UsbJtag() noexcept : Transport(TAG)
+    UsbJtag::UsbJtag(const TransportConfig& transportConfig) noexcept : Transport(TAG, transportConfig)
     {
         ESP_LOGI(TAG, "Initializing USB-JTAG interface");
 
@@ -22,6 +22,10 @@ namespace net
             return;
         }
 
+        // Скорость ограничивает сам драйвер: запись ждёт освобождения TX буфера
+        if (!transportConfig.pacing) setPacing(PacingPolicy::unpaced());
+
+        mDriverInstalled = true;
         setInitialized(true);
         ESP_LOGI(TAG, "USB-JTAG initialized. Buffers: TX=%zu, RX=%zu",
                  USB_JTAG_TX_BUFFER_SIZE, USB_JTAG_RX_BUFFER_SIZE);
@@ -29,7 +33,8 @@ namespace net
 
     UsbJtag::~UsbJtag()
     {
-        if (isInitialized())
+        stop();
+        if (mDriverInstalled)
         {
             usb_serial_jtag_driver_uninstall();
             ESP_LOGI(TAG, "Driver uninstalled");
@@ -41,9 +46,10 @@ namespace net
         return MAX_MTU;
     }
 
-    size_t UsbJtag::read(std::span<uint8_t> buffer) const noexcept
+    size_t UsbJtag::read(std::span<uint8_t> buffer, const TickType_t timeout) const noexcept
     {
-        std::lock_guard lock(mMutex);
+        // Драйвер потокобезопасен; отдельный мьютекс лишь не даёт двум читателям делить поток
+        std::lock_guard lock(mReadMutex);
         if (!isInitialized() || buffer.empty())
         {
             ESP_LOGW(TAG, "Invalid read parameters");
@@ -51,7 +57,7 @@ namespace net
         }
 
         ESP_LOGD(TAG, "Reading %zu bytes", buffer.size());
-        const int len = usb_serial_jtag_read_bytes(buffer.data(), buffer.size(), pdMS_TO_TICKS(50));
+        const int len = usb_serial_jtag_read_bytes(buffer.data(), buffer.size(), timeout);
         if (len < 0)
         {
             ESP_LOGE(TAG, "Failed to read bytes");
@@ -80,14 +86,59 @@ namespace net
         return static_cast<size_t>(len);
     }
 
-    esp_err_t UsbJtag::sendImpl(Packet& packet)
+    esp_err_t UsbJtag::setFraming(const Framing framing)
+    {
+        std::lock_guard lock(mMutex);
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
+        {
+            ESP_LOGE(TAG, "Cannot change framing while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mCodec.setFraming(framing);
+        return ESP_OK;
+    }
+
+    Framing UsbJtag::framing() const
     {
-        ESP_LOGD(TAG, "Writing packet, size: %zu", packet.size);
-        const size_t written = write(std::span(packet.buffer.data(), packet.size));
+        std::lock_guard lock(mMutex);
+        return mCodec.framing();
+    }
 
-        if (written != packet.size)
+    esp_err_t UsbJtag::setIntegrity(const Integrity integrity)
+    {
+        std::lock_guard lock(mMutex);
+        if (mThread.state() != esp32_c3::objects::Thread::State::NOT_RUNNING)
         {
-            ESP_LOGE(TAG, "Failed to write full packet: %zu/%zu bytes", written, packet.size);
+            ESP_LOGE(TAG, "Cannot change integrity check while worker is running");
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        mCodec.setIntegrity(integrity);
+        return ESP_OK;
+    }
+
+    Integrity UsbJtag::integrity() const
+    {
+        std::lock_guard lock(mMutex);
+        return mCodec.integrity();
+    }
+
+    size_t UsbJtag::frameErrors() const
+    {
+        std::lock_guard lock(mMutex);
+        return mCodec.errors();
+    }
+
+    esp_err_t UsbJtag::sendImpl(const PacketRef& packet, Priority)
+    {
+        ESP_LOGD(TAG, "Writing packet, size: %zu", packet->size);
+        // Кодек используется только рабочим потоком, настройки при работе не меняются
+        const std::span<const uint8_t> data = mCodec.encode(*packet);
+        const size_t written = write(data);
+        if (written != data.size())
+        {
+            ESP_LOGE(TAG, "Failed to write full packet: %zu/%zu bytes", written, data.size());
             return ESP_FAIL;
         }
 
@@ -95,19 +146,23 @@ namespace net
         return ESP_OK;
     }
 
-    void UsbJtag::processReceivedData()
+    TickType_t UsbJtag::receivePollInterval() const noexcept
     {
-        if (!mDataCallback) return;
+        return pdMS_TO_TICKS(RX_POLL_INTERVAL_MS);
+    }
 
-        Packet packet{};
-        packet.size = read(std::span<uint8_t>(packet.buffer));
+    void UsbJtag::processReceivedData(QueueSetMemberHandle_t)
+    {
+        if (!hasReceiver()) return;
 
-        if (packet.size > 0)
+        // Поток читается порциями до опустошения буфера драйвера; границы пакетов задаёт кодек
+        size_t len = 0;
+        while ((len = read(mChunk, 0)) > 0)
         {
-            ESP_LOGV(TAG, "Processing %zu bytes", packet.size);
-            mDataCallback->invoke(packet, [&](const Packet& result)
+            mCodec.decode(std::span(mChunk.data(), len), [&](const Packet& packet)
             {
-                send(result);
+                ESP_LOGV(TAG, "Processing %zu bytes", packet.size);
+                dispatchReceived(packet);
             });
         }
     }
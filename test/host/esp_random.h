@@ -0,0 +1,21 @@
+/**
+ * @file esp_random.h
+ * @brief Генератор случайных чисел для тестов на компьютере (env:native)
+ * @details Последовательность детерминирована, поэтому тесты воспроизводимы
+ */
+
+#ifndef NET_TEST_HOST_ESP_RANDOM_H
+#define NET_TEST_HOST_ESP_RANDOM_H
+
+#include <cstdint>
+
+inline uint32_t esp_random()
+{
+    static uint32_t state = 0x2545F491;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+#endif // NET_TEST_HOST_ESP_RANDOM_H
@@ -0,0 +1,18 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Типы FreeRTOS для тестов на компьютере (env:native)
+ */
+
+#ifndef NET_TEST_HOST_FREERTOS_H
+#define NET_TEST_HOST_FREERTOS_H
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xFFFFFFFFu
+
+#endif // NET_TEST_HOST_FREERTOS_H
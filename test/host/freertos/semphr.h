@@ -0,0 +1,36 @@
+/**
+ * @file semphr.h
+ * @brief Двоичный семафор FreeRTOS для тестов на компьютере (env:native)
+ * @details Тесты однопоточные, поэтому xSemaphoreTake не блокируется
+ */
+
+#ifndef NET_TEST_HOST_SEMPHR_H
+#define NET_TEST_HOST_SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+#include <atomic>
+
+struct StaticSemaphore_t
+{
+    std::atomic<bool> given{false}; ///< Семафор отдан
+};
+
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* buffer)
+{
+    return buffer;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    return semaphore->given.exchange(true) ? pdFALSE : pdTRUE;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t)
+{
+    return semaphore->given.exchange(false) ? pdTRUE : pdFALSE;
+}
+
+#endif // NET_TEST_HOST_SEMPHR_H
@@ -0,0 +1,111 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка таблицы логических каналов: классы приоритета и счётчики
+ * @details Запуск на компьютере: pio test -e native -f test_channel
+ */
+
+#include "net/channel.h"
+
+#include <unity.h>
+
+using namespace net;
+
+namespace
+{
+    ChannelTable table;
+} // namespace
+
+void setUp()
+{
+    table.resetStats();
+    for (uint8_t channel = 0; channel < MAX_CHANNELS; channel++) table.setPriority(channel, Priority::INTERACTIVE);
+}
+
+void tearDown()
+{
+}
+
+void test_priority()
+{
+    TEST_ASSERT_TRUE(table.priority(0) == Priority::INTERACTIVE);
+
+    table.setPriority(0, Priority::CONTROL);
+    table.setPriority(MAX_CHANNELS - 1, Priority::BULK);
+    TEST_ASSERT_TRUE(table.priority(0) == Priority::CONTROL);
+    TEST_ASSERT_TRUE(table.priority(1) == Priority::INTERACTIVE);
+    TEST_ASSERT_TRUE(table.priority(MAX_CHANNELS - 1) == Priority::BULK);
+
+    // Номер вне таблицы не меняет каналы и получает класс по умолчанию
+    table.setPriority(MAX_CHANNELS, Priority::CONTROL);
+    TEST_ASSERT_TRUE(table.priority(MAX_CHANNELS) == Priority::INTERACTIVE);
+    TEST_ASSERT_TRUE(table.priority(255) == Priority::INTERACTIVE);
+}
+
+void test_counters()
+{
+    table.onQueued(2, 100);
+    table.onQueued(2, 20);
+    table.onRejected(2);
+    table.onReceived(2, 7);
+    table.onReceived(3, 9);
+
+    const ChannelStats stats = table.stats(2);
+    TEST_ASSERT_EQUAL(2, stats.packetsQueued);
+    TEST_ASSERT_EQUAL(120, stats.bytesQueued);
+    TEST_ASSERT_EQUAL(1, stats.rejected);
+    TEST_ASSERT_EQUAL(1, stats.packetsReceived);
+    TEST_ASSERT_EQUAL(7, stats.bytesReceived);
+
+    // Счётчики каналов независимы
+    TEST_ASSERT_EQUAL(0, table.stats(3).packetsQueued);
+    TEST_ASSERT_EQUAL(9, table.stats(3).bytesReceived);
+}
+
+void test_out_of_range()
+{
+    table.onQueued(MAX_CHANNELS, 10);
+    table.onRejected(MAX_CHANNELS);
+    table.onReceived(MAX_CHANNELS, 10);
+
+    const ChannelStats stats = table.stats(MAX_CHANNELS);
+    TEST_ASSERT_EQUAL(0, stats.packetsQueued);
+    TEST_ASSERT_EQUAL(0, stats.rejected);
+    TEST_ASSERT_EQUAL(0, stats.packetsReceived);
+    for (uint8_t channel = 0; channel < MAX_CHANNELS; channel++)
+    {
+        TEST_ASSERT_EQUAL(0, table.stats(channel).packetsQueued);
+    }
+}
+
+void test_reset_keeps_priority()
+{
+    table.setPriority(4, Priority::BULK);
+    table.onQueued(4, 50);
+    table.resetStats();
+
+    TEST_ASSERT_EQUAL(0, table.stats(4).packetsQueued);
+    TEST_ASSERT_EQUAL(0, table.stats(4).bytesQueued);
+    TEST_ASSERT_TRUE(table.priority(4) == Priority::BULK);
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_priority);
+    RUN_TEST(test_counters);
+    RUN_TEST(test_out_of_range);
+    RUN_TEST(test_reset_keeps_priority);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
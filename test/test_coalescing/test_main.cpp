@@ -0,0 +1,137 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка объединения пакетов: запись, чтение и разбор повреждённого объединённого пакета
+ * @details Запуск на компьютере: pio test -e native -f test_coalescing
+ */
+
+#include "net/coalescing.h"
+
+#include <unity.h>
+
+#include <array>
+#include <initializer_list>
+
+using namespace net;
+
+namespace
+{
+    Packet batch;
+
+    /**
+     * @brief Пакет из size байт со значением marker
+     */
+    Packet make(const uint16_t size, const uint8_t marker)
+    {
+        Packet packet;
+        packet.id = 7;
+        packet.size = size;
+        packet.buffer.fill(marker);
+        return packet;
+    }
+} // namespace
+
+void setUp()
+{
+    batch = {};
+    batch.id = 42;
+}
+
+void tearDown()
+{
+}
+
+void test_record_size()
+{
+    TEST_ASSERT_EQUAL(2, batchRecordSize(1));
+    TEST_ASSERT_EQUAL(128, batchRecordSize(127));
+    TEST_ASSERT_EQUAL(130, batchRecordSize(128));
+    TEST_ASSERT_EQUAL(MAX_MTU + 2, batchRecordSize(MAX_MTU));
+}
+
+void test_round_trip()
+{
+    constexpr std::array<uint16_t, 5> SIZES = {1, 127, 128, 200, 50};
+    size_t expected = 0;
+    for (size_t i = 0; i < SIZES.size(); i++)
+    {
+        TEST_ASSERT_TRUE(appendRecord(batch, make(SIZES[i], static_cast<uint8_t>(i + 1)), MAX_MTU));
+        expected += batchRecordSize(SIZES[i]);
+        TEST_ASSERT_EQUAL(expected, batch.size);
+    }
+
+    // Порядок и размеры сохраняются, Packet::id берётся из объединённого пакета
+    BatchReader reader(batch);
+    Packet out;
+    for (size_t i = 0; i < SIZES.size(); i++)
+    {
+        TEST_ASSERT_TRUE(reader.next(out));
+        TEST_ASSERT_EQUAL(SIZES[i], out.size);
+        TEST_ASSERT_EQUAL(42, out.id);
+        TEST_ASSERT_EQUAL(i + 1, out.buffer[0]);
+        TEST_ASSERT_EQUAL(i + 1, out.buffer[out.size - 1]);
+    }
+    TEST_ASSERT_FALSE(reader.next(out));
+    TEST_ASSERT_FALSE(reader.failed());
+}
+
+void test_limit()
+{
+    TEST_ASSERT_TRUE(appendRecord(batch, make(100, 1), 120));
+
+    // Запись, не помещающаяся в предел, не меняет пакет
+    TEST_ASSERT_FALSE(appendRecord(batch, make(19, 2), 120));
+    TEST_ASSERT_EQUAL(101, batch.size);
+    TEST_ASSERT_TRUE(appendRecord(batch, make(18, 3), 120));
+    TEST_ASSERT_EQUAL(120, batch.size);
+
+    // Предел больше MAX_MTU ограничивается MAX_MTU; пустой пакет не добавляется
+    Packet full;
+    TEST_ASSERT_FALSE(appendRecord(full, make(MAX_MTU, 4), 2 * MAX_MTU));
+    TEST_ASSERT_TRUE(appendRecord(full, make(MAX_MTU - 2, 4), 2 * MAX_MTU));
+    TEST_ASSERT_FALSE(appendRecord(batch, make(0, 5), MAX_MTU));
+}
+
+void test_malformed()
+{
+    const auto expectFailure = [](std::initializer_list<uint8_t> bytes, const size_t valid)
+    {
+        Packet broken;
+        TEST_ASSERT_TRUE(broken.setPayload(bytes.begin(), bytes.size()));
+
+        BatchReader reader(broken);
+        Packet out;
+        for (size_t i = 0; i < valid; i++) TEST_ASSERT_TRUE(reader.next(out));
+        TEST_ASSERT_FALSE(reader.next(out));
+        TEST_ASSERT_TRUE(reader.failed());
+
+        // Ошибка запоминается: дальнейшее чтение не продолжается
+        TEST_ASSERT_FALSE(reader.next(out));
+    };
+
+    expectFailure({0x00, 0x01, 0x41}, 0);             // Нулевая длина
+    expectFailure({0x01, 0x41, 0x03, 0x41, 0x42}, 1); // Запись выходит за пакет
+    expectFailure({0x01, 0x41, 0x80}, 1);             // Обрезанный двухбайтовый заголовок
+    expectFailure({0x82, 0x06, 0x41}, 0);             // Длина больше MAX_MTU
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_record_size);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_limit);
+    RUN_TEST(test_malformed);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
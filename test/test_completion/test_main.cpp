@@ -0,0 +1,142 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка уведомлений о завершении асинхронной отправки
+ * @details Запуск на компьютере: pio test -e native -f test_completion
+ */
+
+#include "net/completion.h"
+#include "net/packet_pool.h"
+
+#include <unity.h>
+
+#include <utility>
+#include <vector>
+
+using namespace net;
+
+namespace
+{
+    CompletionPool& pool = CompletionPool::instance();
+    std::vector<esp_err_t> results; ///< Результаты, переданные в callback
+
+    const CompletionFunction record = [](const esp_err_t result) { results.push_back(result); };
+} // namespace
+
+void setUp()
+{
+    results.clear();
+}
+
+void tearDown()
+{
+}
+
+void test_complete_once()
+{
+    SendHandle handle = pool.acquire(record);
+    TEST_ASSERT_TRUE(handle.id() != 0);
+    TEST_ASSERT_FALSE(handle.ready());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, handle.result());
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, handle.wait(0));
+
+    // Первое завершение фиксирует результат, повторные игнорируются
+    pool.complete(handle.id(), ESP_ERR_NO_MEM);
+    pool.complete(handle.id(), ESP_OK);
+    TEST_ASSERT_TRUE(handle.ready());
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, handle.result());
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, handle.wait(0));
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, handle.wait());
+    TEST_ASSERT_EQUAL(1, results.size());
+}
+
+void test_handle_outlives_packet()
+{
+    SendHandle handle = pool.acquire(record);
+    {
+        // Ссылку удерживает пакет в очереди; пакет, брошенный без завершения, завершает отправку
+        PacketRef packet = PacketPool::instance().acquire();
+        TEST_ASSERT_TRUE(static_cast<bool>(packet));
+        pool.retain(handle.id());
+        packet.setCompletion(handle.id());
+    }
+    TEST_ASSERT_TRUE(handle.ready());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, handle.result());
+    TEST_ASSERT_EQUAL(1, results.size());
+}
+
+void test_packet_outlives_handle()
+{
+    CompletionId id = 0;
+    {
+        // Уничтожение дескриптора не отменяет callback
+        const SendHandle handle = pool.acquire(record);
+        id = handle.id();
+        pool.retain(id);
+    }
+    TEST_ASSERT_EQUAL(0, results.size());
+
+    pool.complete(id, ESP_OK);
+    pool.release(id);
+    TEST_ASSERT_EQUAL(1, results.size());
+    TEST_ASSERT_EQUAL(ESP_OK, results[0]);
+}
+
+void test_exhaustion()
+{
+    std::vector<SendHandle> handles;
+    for (size_t i = 0; i < CompletionPool::CAPACITY; i++)
+    {
+        handles.push_back(pool.acquire(nullptr));
+        TEST_ASSERT_TRUE(handles.back().id() != 0);
+    }
+
+    // Без ячейки дескриптор сразу завершён с ESP_ERR_NO_MEM
+    const SendHandle extra = pool.acquire(record);
+    TEST_ASSERT_EQUAL(0, extra.id());
+    TEST_ASSERT_TRUE(extra.ready());
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, extra.result());
+
+    // Освобождённая ячейка используется снова
+    handles.pop_back();
+    SendHandle reused = pool.acquire(record);
+    TEST_ASSERT_TRUE(reused.id() != 0);
+    TEST_ASSERT_FALSE(reused.ready());
+}
+
+void test_move()
+{
+    SendHandle first = pool.acquire(record);
+    const CompletionId id = first.id();
+
+    SendHandle second = std::move(first);
+    TEST_ASSERT_EQUAL(0, first.id());
+    TEST_ASSERT_EQUAL(id, second.id());
+
+    // Перезапись дескриптора освобождает его прежнюю ячейку
+    second = pool.acquire(nullptr);
+    TEST_ASSERT_EQUAL(1, results.size());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, results[0]);
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_complete_once);
+    RUN_TEST(test_handle_outlives_packet);
+    RUN_TEST(test_packet_outlives_handle);
+    RUN_TEST(test_exhaustion);
+    RUN_TEST(test_move);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
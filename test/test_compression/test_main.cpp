@@ -0,0 +1,165 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка сжатия полезной нагрузки LZ: восстановление данных и разбор повреждённого потока
+ * @details Запуск на компьютере: pio test -e native -f test_compression
+ */
+
+#include "net/compression.h"
+
+#include <unity.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+using namespace net;
+
+namespace
+{
+    constexpr size_t FRAME_SIZE = 517; ///< MAX_MTU
+
+    std::array<uint8_t, FRAME_SIZE> text;   ///< Сжимаемые данные (повторяющиеся записи)
+    std::array<uint8_t, FRAME_SIZE> noise;  ///< Несжимаемые данные
+    std::array<uint8_t, FRAME_SIZE + COMPRESSION_OVERHEAD> packed;
+    std::array<uint8_t, FRAME_SIZE> unpacked;
+
+    /**
+     * @brief Сжать и восстановить data, проверив совпадение
+     * @return size_t Размер сжатой нагрузки с байтом формата
+     */
+    size_t roundTrip(const std::span<const uint8_t> data)
+    {
+        const size_t size = compressPayload(data, packed);
+        TEST_ASSERT_TRUE(size > 0 && size <= data.size() + COMPRESSION_OVERHEAD);
+
+        TEST_ASSERT_EQUAL(data.size(), decompressPayload(std::span(packed).first(size), unpacked));
+        TEST_ASSERT_EQUAL_MEMORY(data.data(), unpacked.data(), data.size());
+        return size;
+    }
+} // namespace
+
+void setUp()
+{
+    for (size_t i = 0; i < text.size(); i += 32)
+    {
+        char record[33];
+        std::snprintf(record, sizeof(record), "{\"id\":%3u,\"temp\":21.5,\"ok\":1}\n", static_cast<unsigned>(i / 32));
+        std::memcpy(text.data() + i, record, std::min<size_t>(32, text.size() - i));
+    }
+
+    uint32_t seed = 0xC0FFEE;
+    for (uint8_t& byte : noise)
+    {
+        seed = seed * 1664525 + 1013904223;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+}
+
+void tearDown()
+{
+}
+
+void test_round_trip_sizes()
+{
+    for (size_t size = 1; size <= FRAME_SIZE; size++)
+    {
+        (void)roundTrip(std::span(text).first(size));
+        (void)roundTrip(std::span(noise).first(size));
+    }
+}
+
+void test_format_choice()
+{
+    // Повторяющиеся записи сжимаются, случайные данные передаются без сжатия
+    const size_t compressed = roundTrip(text);
+    TEST_ASSERT_EQUAL(COMPRESSION_LZ, packed[0]);
+    TEST_ASSERT_TRUE(compressed < text.size() / 2);
+    printf("text: %u -> %u bytes\n", static_cast<unsigned>(text.size()), static_cast<unsigned>(compressed));
+
+    TEST_ASSERT_EQUAL(noise.size() + COMPRESSION_OVERHEAD, roundTrip(noise));
+    TEST_ASSERT_EQUAL(COMPRESSION_RAW, packed[0]);
+}
+
+void test_overlapping_match()
+{
+    // Серия одного байта кодируется повтором, перекрывающим сам себя
+    std::array<uint8_t, FRAME_SIZE> run;
+    run.fill(0x41);
+    run[0] = 0x7E;
+    TEST_ASSERT_TRUE(roundTrip(run) < 40);
+    TEST_ASSERT_EQUAL(COMPRESSION_LZ, packed[0]);
+}
+
+void test_small_output()
+{
+    std::array<uint8_t, 16> small{};
+    TEST_ASSERT_EQUAL(0, lzCompress(noise, small));
+    TEST_ASSERT_EQUAL(0, compressPayload(noise, small));
+    TEST_ASSERT_EQUAL(0, compressPayload(noise, {}));
+
+    // Распаковка в слишком маленький буфер
+    const size_t size = compressPayload(text, packed);
+    TEST_ASSERT_EQUAL(0, decompressPayload(std::span(packed).first(size), small));
+}
+
+void test_malformed()
+{
+    // Нет данных после байта формата, неизвестный формат
+    const std::array<uint8_t, 1> formatOnly = {COMPRESSION_LZ};
+    TEST_ASSERT_EQUAL(0, decompressPayload(formatOnly, unpacked));
+    const std::array<uint8_t, 3> unknown = {0x7F, 0x00, 0x41};
+    TEST_ASSERT_EQUAL(0, decompressPayload(unknown, unpacked));
+
+    // Серия литералов длиннее данных
+    const std::array<uint8_t, 3> literals = {0x05, 0x41, 0x42};
+    TEST_ASSERT_EQUAL(0, lzDecompress(literals, unpacked));
+
+    // Повтор без второго байта и повтор до начала данных
+    const std::array<uint8_t, 3> truncated = {0x00, 0x41, 0x80};
+    TEST_ASSERT_EQUAL(0, lzDecompress(truncated, unpacked));
+    const std::array<uint8_t, 4> before = {0x00, 0x41, 0x80, 0x01};
+    TEST_ASSERT_EQUAL(0, lzDecompress(before, unpacked));
+
+    // Повреждение любого байта сжатых данных не выходит за границы буфера
+    const size_t size = compressPayload(text, packed);
+    for (size_t i = COMPRESSION_OVERHEAD; i < size; i++)
+    {
+        const uint8_t saved = packed[i];
+        packed[i] ^= 0xA5;
+        TEST_ASSERT_TRUE(decompressPayload(std::span(packed).first(size), unpacked) <= unpacked.size());
+        packed[i] = saved;
+    }
+}
+
+void test_oversized_input()
+{
+    // Позиции хэш-таблицы 16-битные: данные больше формата не сжимаются
+    static std::array<uint8_t, 0x10000> large{};
+    static std::array<uint8_t, 0x10000> out{};
+    TEST_ASSERT_EQUAL(0, lzCompress(large, out));
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_sizes);
+    RUN_TEST(test_format_choice);
+    RUN_TEST(test_overlapping_match);
+    RUN_TEST(test_small_output);
+    RUN_TEST(test_malformed);
+    RUN_TEST(test_oversized_input);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
@@ -0,0 +1,247 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка и сравнение реализаций CRC: побитовая, побайтовая таблица ПЗУ и slice-by-8
+ * @details Запуск на компьютере: pio test -e native -v (время выводится в лог теста).
+ *          На ESP32 (pio test -e lolin_c3_mini) вместо эмуляции вызываются функции ПЗУ.
+ */
+
+#include "net/crc.h"
+
+#include <unity.h>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+#ifdef ESP_PLATFORM
+#include "esp_rom_crc.h"
+#endif
+
+using namespace net;
+
+namespace
+{
+    constexpr size_t FRAME_SIZE = 517; ///< MAX_MTU (packet.h требует ESP-IDF)
+    constexpr std::array<uint8_t, 9> CHECK = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+#ifdef ESP_PLATFORM
+    constexpr int ITERATIONS = 200; ///< Повторов на размер кадра
+#else
+    constexpr int ITERATIONS = 20000; ///< Повторов на размер кадра
+#endif
+
+    std::array<uint8_t, FRAME_SIZE> frame;
+    volatile uint32_t sink; ///< Не даёт компилятору выбросить вычисления
+
+    /**
+     * @brief Эталонный побитовый CRC (отражённый, с начальной и конечной инверсией)
+     */
+    uint32_t bitwise(const uint32_t poly, const uint32_t mask, const std::span<const uint8_t> data,
+                     const uint32_t init) noexcept
+    {
+        uint32_t crc = ~init & mask;
+        for (const uint8_t byte : data)
+        {
+            crc ^= byte;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = crc & 1 ? (crc >> 1) ^ poly : crc >> 1;
+            }
+        }
+        return ~crc & mask;
+    }
+
+    uint32_t crc32Bitwise(const std::span<const uint8_t> data, const uint32_t crc = 0) noexcept
+    {
+        return bitwise(0xEDB88320, 0xFFFFFFFF, data, crc);
+    }
+
+    uint16_t crc16Bitwise(const std::span<const uint8_t> data, const uint16_t crc = 0) noexcept
+    {
+        return static_cast<uint16_t>(bitwise(0x8408, 0xFFFF, data, crc));
+    }
+
+#ifdef ESP_PLATFORM
+    uint32_t crc32Rom(const std::span<const uint8_t> data, const uint32_t crc = 0) noexcept
+    {
+        return esp_rom_crc32_le(crc, data.data(), data.size());
+    }
+
+    uint16_t crc16Rom(const std::span<const uint8_t> data, const uint16_t crc = 0) noexcept
+    {
+        return esp_rom_crc16_le(crc, data.data(), data.size());
+    }
+#else
+    /**
+     * @brief Побайтовая таблица - алгоритм функций ПЗУ esp_rom_crc32_le / esp_rom_crc16_le
+     */
+    template <uint32_t POLY>
+    struct ByteTable
+    {
+        std::array<uint32_t, 256> table{};
+
+        constexpr ByteTable() noexcept
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
+                }
+                table[i] = crc;
+            }
+        }
+
+        [[nodiscard]] uint32_t update(uint32_t crc, const std::span<const uint8_t> data) const noexcept
+        {
+            for (const uint8_t byte : data)
+            {
+                crc = (crc >> 8) ^ table[(crc ^ byte) & 0xFF];
+            }
+            return crc;
+        }
+    };
+
+    constexpr ByteTable<0xEDB88320> CRC32_ROM;
+    constexpr ByteTable<0x8408> CRC16_ROM;
+
+    uint32_t crc32Rom(const std::span<const uint8_t> data, const uint32_t crc = 0) noexcept
+    {
+        return ~CRC32_ROM.update(~crc, data);
+    }
+
+    uint16_t crc16Rom(const std::span<const uint8_t> data, const uint16_t crc = 0) noexcept
+    {
+        return static_cast<uint16_t>(~CRC16_ROM.update(static_cast<uint16_t>(~crc), data));
+    }
+#endif
+
+    /**
+     * @brief Среднее время одного вычисления (нс)
+     */
+    template <typename Function>
+    double measure(Function function, const size_t size) noexcept
+    {
+        const std::span<const uint8_t> data(frame.data(), size);
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            sink = function(data, sink);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS;
+    }
+
+    template <typename Function>
+    void report(const char* name, Function function) noexcept
+    {
+        for (const size_t size : {size_t{16}, size_t{64}, size_t{256}, size_t{FRAME_SIZE}})
+        {
+            const double ns = measure(function, size);
+            printf("%-14s %4u bytes: %10.1f ns, %7.1f MB/s\n", name, static_cast<unsigned>(size), ns,
+                   static_cast<double>(size) * 1000.0 / ns);
+        }
+    }
+} // namespace
+
+void setUp()
+{
+    uint32_t seed = 0x12345678;
+    for (uint8_t& byte : frame)
+    {
+        seed = seed * 1664525 + 1013904223;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+}
+
+void tearDown()
+{
+}
+
+void test_check_values()
+{
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Bitwise(CHECK));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Rom(CHECK));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Table(CHECK));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32(CHECK));
+
+    TEST_ASSERT_EQUAL_HEX16(0x906E, crc16Bitwise(CHECK));
+    TEST_ASSERT_EQUAL_HEX16(0x906E, crc16Rom(CHECK));
+    TEST_ASSERT_EQUAL_HEX16(0x906E, crc16Table(CHECK));
+    TEST_ASSERT_EQUAL_HEX16(0x906E, crc16(CHECK));
+}
+
+void test_implementations_match()
+{
+    // Все длины до MTU: slice-by-8 проходит и по 8 байт, и по хвосту
+    for (size_t size = 0; size <= FRAME_SIZE; size++)
+    {
+        const std::span<const uint8_t> data(frame.data(), size);
+        TEST_ASSERT_EQUAL_HEX32(crc32Bitwise(data), crc32Rom(data));
+        TEST_ASSERT_EQUAL_HEX32(crc32Bitwise(data), crc32Table(data));
+        TEST_ASSERT_EQUAL_HEX16(crc16Bitwise(data), crc16Rom(data));
+        TEST_ASSERT_EQUAL_HEX16(crc16Bitwise(data), crc16Table(data));
+    }
+}
+
+void test_chained()
+{
+    const std::span<const uint8_t> data(frame);
+    for (const size_t split : {size_t{1}, size_t{7}, size_t{8}, size_t{100}, size_t{FRAME_SIZE - 1}})
+    {
+        TEST_ASSERT_EQUAL_HEX32(crc32Table(data), crc32Table(data.subspan(split), crc32Table(data.first(split))));
+        TEST_ASSERT_EQUAL_HEX16(crc16Table(data), crc16Table(data.subspan(split), crc16Table(data.first(split))));
+    }
+}
+
+void test_integrity_trailer()
+{
+    for (const Integrity integrity : {Integrity::NONE, Integrity::CRC16, Integrity::CRC32})
+    {
+        std::array<uint8_t, FRAME_SIZE + MAX_INTEGRITY_SIZE> buffer{};
+        std::copy(frame.begin(), frame.end(), buffer.begin());
+
+        const size_t size = appendIntegrity(integrity, buffer, FRAME_SIZE);
+        TEST_ASSERT_EQUAL(FRAME_SIZE + integritySize(integrity), size);
+        TEST_ASSERT_EQUAL(FRAME_SIZE, verifyIntegrity(integrity, std::span(buffer).first(size)));
+
+        if (integrity == Integrity::NONE) continue;
+        TEST_ASSERT_EQUAL(0, appendIntegrity(integrity, std::span(buffer).first(FRAME_SIZE), FRAME_SIZE));
+        buffer[FRAME_SIZE / 2] ^= 0x01;
+        TEST_ASSERT_EQUAL(0, verifyIntegrity(integrity, std::span(buffer).first(size)));
+    }
+}
+
+void test_benchmark()
+{
+    report("crc32 bitwise", crc32Bitwise);
+    report("crc32 rom", crc32Rom);
+    report("crc32 slice-8", crc32Table);
+    report("crc16 bitwise", crc16Bitwise);
+    report("crc16 rom", crc16Rom);
+    report("crc16 slice-8", crc16Table);
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_check_values);
+    RUN_TEST(test_implementations_match);
+    RUN_TEST(test_chained);
+    RUN_TEST(test_integrity_trailer);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
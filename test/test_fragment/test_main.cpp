@@ -0,0 +1,174 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка фрагментации по MTU и сборки фрагментов
+ * @details Запуск на компьютере: pio test -e native -f test_fragment
+ */
+
+#include "net/fragment.h"
+
+#include <unity.h>
+
+#include <array>
+#include <vector>
+
+using namespace net;
+
+namespace
+{
+    constexpr size_t MIN_PAYLOAD = 20; ///< Полезная нагрузка уведомления при ATT MTU 23
+
+    Packet source;
+    Reassembler reassembler;
+
+    /**
+     * @brief Разбить source на фрагменты не больше size байт (с заголовком)
+     */
+    std::vector<std::vector<uint8_t>> split(const size_t size)
+    {
+        std::vector<std::vector<uint8_t>> fragments;
+        std::vector<uint8_t> out(size);
+        size_t offset = 0;
+        uint8_t index = 0;
+        while (offset < source.size)
+        {
+            const size_t len = writeFragment(source, offset, index++, out);
+            TEST_ASSERT_TRUE(len > 0);
+            fragments.emplace_back(out.begin(), out.begin() + static_cast<long>(len + FragmentHeader::SIZE));
+            offset += len;
+        }
+        return fragments;
+    }
+
+    /**
+     * @brief Передать фрагменты сборщику, ожидая пакет на последнем
+     */
+    void assemble(const std::vector<std::vector<uint8_t>>& fragments)
+    {
+        for (size_t i = 0; i < fragments.size(); i++)
+        {
+            const Reassembler::Result expected =
+                i + 1 < fragments.size() ? Reassembler::Result::INCOMPLETE : Reassembler::Result::COMPLETE;
+            TEST_ASSERT_TRUE(reassembler.push(fragments[i]) == expected);
+        }
+    }
+} // namespace
+
+void setUp()
+{
+    source.size = MAX_MTU;
+    for (size_t i = 0; i < MAX_MTU; i++) source.buffer[i] = static_cast<uint8_t>(i * 7 + 3);
+    reassembler.reset();
+}
+
+void tearDown()
+{
+}
+
+void test_round_trip()
+{
+    for (const size_t size : {MIN_PAYLOAD, size_t{64}, size_t{244}, size_t{MAX_MTU + FragmentHeader::SIZE}})
+    {
+        const auto fragments = split(size);
+        TEST_ASSERT_EQUAL((MAX_MTU + size - FragmentHeader::SIZE - 1) / (size - FragmentHeader::SIZE),
+                          fragments.size());
+        TEST_ASSERT_EQUAL(FragmentHeader::FIRST, fragments.front()[0] & FragmentHeader::FIRST);
+        TEST_ASSERT_EQUAL(FragmentHeader::LAST, fragments.back()[0] & FragmentHeader::LAST);
+
+        assemble(fragments);
+        TEST_ASSERT_EQUAL(MAX_MTU, reassembler.packet().size);
+        TEST_ASSERT_EQUAL_MEMORY(source.buffer.data(), reassembler.packet().buffer.data(), MAX_MTU);
+    }
+}
+
+void test_single_fragment()
+{
+    source.size = 5;
+    const auto fragments = split(MIN_PAYLOAD);
+    TEST_ASSERT_EQUAL(1, fragments.size());
+    TEST_ASSERT_EQUAL(FragmentHeader::FIRST | FragmentHeader::LAST, fragments[0][0]);
+
+    assemble(fragments);
+    TEST_ASSERT_EQUAL(5, reassembler.packet().size);
+}
+
+void test_write_limits()
+{
+    std::array<uint8_t, FragmentHeader::SIZE> header{};
+    TEST_ASSERT_EQUAL(0, writeFragment(source, 0, 0, header));
+
+    std::array<uint8_t, MIN_PAYLOAD> out{};
+    TEST_ASSERT_EQUAL(0, writeFragment(source, source.size, 0, out));
+}
+
+void test_lost_fragment()
+{
+    auto fragments = split(MIN_PAYLOAD);
+    fragments.erase(fragments.begin() + 2);
+
+    // Пропуск номера сбрасывает сборку, следующий пакет собирается заново
+    TEST_ASSERT_TRUE(reassembler.push(fragments[0]) == Reassembler::Result::INCOMPLETE);
+    TEST_ASSERT_TRUE(reassembler.push(fragments[1]) == Reassembler::Result::INCOMPLETE);
+    TEST_ASSERT_TRUE(reassembler.push(fragments[2]) == Reassembler::Result::ERROR);
+    TEST_ASSERT_TRUE(reassembler.push(fragments[3]) == Reassembler::Result::ERROR);
+
+    assemble(split(MIN_PAYLOAD));
+    TEST_ASSERT_EQUAL(MAX_MTU, reassembler.packet().size);
+}
+
+void test_restart_on_first()
+{
+    const auto fragments = split(MIN_PAYLOAD);
+
+    // Незавершённый пакет отбрасывается новым первым фрагментом
+    TEST_ASSERT_TRUE(reassembler.push(fragments[0]) == Reassembler::Result::INCOMPLETE);
+    TEST_ASSERT_TRUE(reassembler.push(fragments[1]) == Reassembler::Result::INCOMPLETE);
+    assemble(fragments);
+    TEST_ASSERT_EQUAL(MAX_MTU, reassembler.packet().size);
+    TEST_ASSERT_EQUAL_MEMORY(source.buffer.data(), reassembler.packet().buffer.data(), MAX_MTU);
+}
+
+void test_malformed()
+{
+    TEST_ASSERT_TRUE(reassembler.push({}) == Reassembler::Result::ERROR);
+
+    // Продолжение без первого фрагмента
+    const std::array<uint8_t, 3> middle = {1, 0xAA, 0xBB};
+    TEST_ASSERT_TRUE(reassembler.push(middle) == Reassembler::Result::ERROR);
+
+    // Пустой пакет
+    const std::array<uint8_t, 1> empty = {FragmentHeader::FIRST | FragmentHeader::LAST};
+    TEST_ASSERT_TRUE(reassembler.push(empty) == Reassembler::Result::ERROR);
+
+    // Переполнение MAX_MTU: фрагменты без флага LAST
+    std::array<uint8_t, 201> chunk{};
+    chunk[0] = FragmentHeader::FIRST;
+    TEST_ASSERT_TRUE(reassembler.push(chunk) == Reassembler::Result::INCOMPLETE);
+    chunk[0] = 1;
+    TEST_ASSERT_TRUE(reassembler.push(chunk) == Reassembler::Result::INCOMPLETE);
+    chunk[0] = 2;
+    TEST_ASSERT_TRUE(reassembler.push(chunk) == Reassembler::Result::ERROR);
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_single_fragment);
+    RUN_TEST(test_write_limits);
+    RUN_TEST(test_lost_fragment);
+    RUN_TEST(test_restart_on_first);
+    RUN_TEST(test_malformed);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
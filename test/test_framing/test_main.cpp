@@ -0,0 +1,263 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка кадрирования COBS: кодирование, потоковый декодер и восстановление синхронизации
+ * @details Запуск на компьютере: pio test -e native -f test_framing
+ */
+
+#include "net/framing.h"
+
+#include <unity.h>
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+using namespace net;
+
+namespace
+{
+    std::array<uint8_t, MAX_MTU> data;
+    std::array<uint8_t, cobsMaxEncodedSize(MAX_MTU)> encoded;
+    std::array<uint8_t, MAX_MTU> decoded;
+    std::vector<std::vector<uint8_t>> frames; ///< Кадры, выданные декодером
+
+    /**
+     * @brief Закодировать data.first(size) кадром потока (с разделителем)
+     */
+    std::vector<uint8_t> frame(const size_t size)
+    {
+        const size_t len = cobsEncode(std::span(data).first(size), encoded);
+        std::vector<uint8_t> out(encoded.begin(), encoded.begin() + static_cast<long>(len));
+        out.push_back(COBS_DELIMITER);
+        return out;
+    }
+
+    /**
+     * @brief Передать поток декодеру порциями по chunk байт
+     */
+    void feed(FrameDecoder& decoder, const std::vector<uint8_t>& stream, const size_t chunk)
+    {
+        for (size_t offset = 0; offset < stream.size(); offset += chunk)
+        {
+            const size_t len = std::min(chunk, stream.size() - offset);
+            decoder.feed(std::span(stream).subspan(offset, len), [](const std::span<const uint8_t> frame)
+            {
+                frames.emplace_back(frame.begin(), frame.end());
+            });
+        }
+    }
+
+    void expectVector(const std::vector<uint8_t>& expected, const std::span<const uint8_t> actual)
+    {
+        TEST_ASSERT_EQUAL(expected.size(), actual.size());
+        if (expected.size() == actual.size()) TEST_ASSERT_EQUAL_MEMORY(expected.data(), actual.data(), actual.size());
+    }
+} // namespace
+
+void setUp()
+{
+    // Примерно каждый восьмой байт нулевой
+    uint32_t seed = 0x9E3779B9;
+    for (uint8_t& byte : data)
+    {
+        seed = seed * 1664525 + 1013904223;
+        byte = (seed >> 29) == 0 ? 0 : static_cast<uint8_t>(seed >> 24);
+    }
+    frames.clear();
+}
+
+void tearDown()
+{
+}
+
+void test_cobs_vectors()
+{
+    const std::vector<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>> vectors = {
+        {{0x00}, {0x01, 0x01}},
+        {{0x00, 0x00}, {0x01, 0x01, 0x01}},
+        {{0x11, 0x22, 0x00, 0x33}, {0x03, 0x11, 0x22, 0x02, 0x33}},
+        {{0x11, 0x22, 0x33, 0x44}, {0x05, 0x11, 0x22, 0x33, 0x44}},
+        {{0x11, 0x00, 0x00, 0x00}, {0x02, 0x11, 0x01, 0x01, 0x01}},
+    };
+
+    for (const auto& [plain, code] : vectors)
+    {
+        expectVector(code, std::span(encoded).first(cobsEncode(plain, encoded)));
+        expectVector(plain, std::span(decoded).first(cobsDecode(code, decoded)));
+    }
+}
+
+void test_cobs_round_trip()
+{
+    for (size_t size = 1; size <= MAX_MTU; size++)
+    {
+        const size_t len = cobsEncode(std::span(data).first(size), encoded);
+        TEST_ASSERT_TRUE(len > size && len <= cobsMaxEncodedSize(size));
+        for (size_t i = 0; i < len; i++) TEST_ASSERT_TRUE(encoded[i] != COBS_DELIMITER);
+
+        TEST_ASSERT_EQUAL(size, cobsDecode(std::span(encoded).first(len), decoded));
+        TEST_ASSERT_EQUAL_MEMORY(data.data(), decoded.data(), size);
+    }
+
+    // Блоки максимальной длины без нулевых байтов
+    data.fill(0x5A);
+    const size_t len = cobsEncode(data, encoded);
+    TEST_ASSERT_EQUAL(0xFF, encoded[0]);
+    TEST_ASSERT_EQUAL(MAX_MTU, cobsDecode(std::span(encoded).first(len), decoded));
+    TEST_ASSERT_EQUAL_MEMORY(data.data(), decoded.data(), MAX_MTU);
+}
+
+void test_cobs_in_place()
+{
+    const size_t len = cobsEncode(data, encoded);
+    TEST_ASSERT_EQUAL(MAX_MTU, cobsDecode(std::span(encoded).first(len), encoded));
+    TEST_ASSERT_EQUAL_MEMORY(data.data(), encoded.data(), MAX_MTU);
+}
+
+void test_cobs_malformed()
+{
+    const std::array<uint8_t, 3> zero = {0x02, 0x00, 0x11};
+    TEST_ASSERT_EQUAL(0, cobsDecode(zero, decoded));
+
+    // Длина блока выходит за кадр
+    const std::array<uint8_t, 3> truncated = {0x05, 0x11, 0x22};
+    TEST_ASSERT_EQUAL(0, cobsDecode(truncated, decoded));
+
+    // Буфер результата мал
+    const size_t len = cobsEncode(data, encoded);
+    TEST_ASSERT_EQUAL(0, cobsDecode(std::span(encoded).first(len), std::span(decoded).first(100)));
+    TEST_ASSERT_EQUAL(0, cobsEncode(data, std::span(encoded).first(MAX_MTU)));
+}
+
+void test_decoder_chunks()
+{
+    std::vector<uint8_t> stream;
+    for (const size_t size : {size_t{1}, size_t{37}, size_t{254}, size_t{255}, size_t{MAX_MTU}})
+    {
+        const std::vector<uint8_t> next = frame(size);
+        stream.insert(stream.end(), next.begin(), next.end());
+    }
+
+    for (const size_t chunk : {size_t{1}, size_t{7}, size_t{64}, stream.size()})
+    {
+        FrameDecoder decoder;
+        frames.clear();
+        feed(decoder, stream, chunk);
+
+        TEST_ASSERT_EQUAL(5, frames.size());
+        TEST_ASSERT_EQUAL(0, decoder.errors());
+        if (frames.size() == 5)
+        {
+            TEST_ASSERT_EQUAL(MAX_MTU, frames[4].size());
+            TEST_ASSERT_EQUAL_MEMORY(data.data(), frames[4].data(), MAX_MTU);
+        }
+    }
+}
+
+void test_decoder_resync()
+{
+    // Хвост оборванного кадра, лишние разделители и шум до следующего разделителя
+    std::vector<uint8_t> stream = {0x37, 0x11, 0x22, COBS_DELIMITER, COBS_DELIMITER, COBS_DELIMITER};
+    const std::vector<uint8_t> good = frame(100);
+    stream.insert(stream.end(), good.begin(), good.end());
+    stream.insert(stream.end(), {0x09, 0x01, COBS_DELIMITER});
+    stream.insert(stream.end(), good.begin(), good.end());
+
+    FrameDecoder decoder;
+    feed(decoder, stream, 5);
+    TEST_ASSERT_EQUAL(2, frames.size());
+    TEST_ASSERT_EQUAL(2, decoder.errors());
+    for (const auto& received : frames) expectVector(std::vector(data.begin(), data.begin() + 100), received);
+}
+
+void test_decoder_overflow()
+{
+    // Поток без разделителей длиннее кадра отбрасывается целиком
+    std::vector<uint8_t> stream(cobsMaxEncodedSize(FrameDecoder::MAX_FRAME_SIZE) + 50, 0x42);
+    stream.push_back(COBS_DELIMITER);
+    const std::vector<uint8_t> good = frame(10);
+    stream.insert(stream.end(), good.begin(), good.end());
+
+    FrameDecoder decoder;
+    feed(decoder, stream, 64);
+    TEST_ASSERT_EQUAL(1, frames.size());
+    TEST_ASSERT_EQUAL(1, decoder.errors());
+    if (!frames.empty()) TEST_ASSERT_EQUAL(10, frames[0].size());
+}
+
+void test_codec_integrity()
+{
+    StreamCodec sender;
+    StreamCodec receiver;
+    for (StreamCodec* codec : {&sender, &receiver})
+    {
+        codec->setFraming(Framing::COBS);
+        codec->setIntegrity(Integrity::CRC16);
+    }
+
+    Packet packet;
+    TEST_ASSERT_TRUE(packet.setPayload(data.data(), 200));
+    const std::span<const uint8_t> wire = sender.encode(packet);
+    std::vector<uint8_t> stream(wire.begin(), wire.end());
+    std::vector<uint8_t> corrupted = stream;
+    corrupted[50] = corrupted[50] == 0x01 ? 0x02 : 0x01;
+    stream.insert(stream.begin(), corrupted.begin(), corrupted.end());
+
+    std::vector<Packet> packets;
+    receiver.decode(stream, [&](const Packet& received) { packets.push_back(received); });
+    TEST_ASSERT_EQUAL(1, packets.size());
+    TEST_ASSERT_EQUAL(1, receiver.errors());
+    if (!packets.empty())
+    {
+        TEST_ASSERT_EQUAL(200, packets[0].size);
+        TEST_ASSERT_EQUAL_MEMORY(data.data(), packets[0].buffer.data(), 200);
+    }
+}
+
+void test_codec_raw()
+{
+    StreamCodec codec;
+    TEST_ASSERT_TRUE(codec.framing() == Framing::RAW);
+
+    Packet packet;
+    TEST_ASSERT_TRUE(packet.setPayload(data.data(), 64));
+    const std::span<const uint8_t> wire = codec.encode(packet);
+    TEST_ASSERT_EQUAL(64, wire.size());
+
+    // Без кадрирования пакетом считается вся порция
+    size_t count = 0;
+    codec.decode(wire, [&](const Packet& received)
+    {
+        count++;
+        TEST_ASSERT_EQUAL(64, received.size);
+    });
+    TEST_ASSERT_EQUAL(1, count);
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cobs_vectors);
+    RUN_TEST(test_cobs_round_trip);
+    RUN_TEST(test_cobs_in_place);
+    RUN_TEST(test_cobs_malformed);
+    RUN_TEST(test_decoder_chunks);
+    RUN_TEST(test_decoder_resync);
+    RUN_TEST(test_decoder_overflow);
+    RUN_TEST(test_codec_integrity);
+    RUN_TEST(test_codec_raw);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка пула пакетов: выделение, подсчёт ссылок и резервы транспортов
+ * @details Запуск на компьютере: pio test -e native -f test_packet_pool
+ */
+
+#include "net/packet_pool.h"
+
+#include <unity.h>
+
+#include <utility>
+#include <vector>
+
+using namespace net;
+
+namespace
+{
+    PacketPool& pool = PacketPool::instance();
+
+    /**
+     * @brief Выделять ячейки, пока пул не откажет
+     */
+    std::vector<PacketRef> exhaust(const PacketPool::ReservationId reservation)
+    {
+        std::vector<PacketRef> packets;
+        while (PacketRef packet = pool.acquire(reservation)) packets.push_back(std::move(packet));
+        return packets;
+    }
+} // namespace
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY, pool.available());
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY, pool.shared());
+}
+
+void test_refcount()
+{
+    PacketRef first = pool.acquire();
+    TEST_ASSERT_TRUE(static_cast<bool>(first));
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY - 1, pool.available());
+
+    // Копия дескриптора удерживает ту же ячейку
+    PacketRef copy = first;
+    first.reset();
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY - 1, pool.available());
+    copy.reset();
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY, pool.available());
+}
+
+void test_copy_packet()
+{
+    Packet packet;
+    packet.id = 5;
+    packet.size = 3;
+    packet.buffer[2] = 0x42;
+
+    const PacketRef ref = pool.acquire(packet);
+    TEST_ASSERT_TRUE(static_cast<bool>(ref));
+    TEST_ASSERT_EQUAL(5, ref->id);
+    TEST_ASSERT_EQUAL(3, ref->size);
+    TEST_ASSERT_EQUAL(0x42, ref->buffer[2]);
+
+    // Размер больше MAX_MTU не копируется
+    packet.size = MAX_MTU + 1;
+    TEST_ASSERT_FALSE(static_cast<bool>(pool.acquire(packet)));
+}
+
+void test_reservation()
+{
+    const PacketPool::ReservationId id = pool.reserve(4);
+    TEST_ASSERT_TRUE(id != 0);
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY - 4, pool.shared());
+
+    // Общая часть исчерпана, но резерв владельца остаётся доступен
+    std::vector<PacketRef> others = exhaust(0);
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY - 4, others.size());
+    std::vector<PacketRef> owned = exhaust(id);
+    TEST_ASSERT_EQUAL(4, owned.size());
+
+    // Освобождённая ячейка резерва возвращается владельцу, а не в общую часть
+    owned.pop_back();
+    TEST_ASSERT_FALSE(static_cast<bool>(pool.acquire()));
+    owned.push_back(pool.acquire(id));
+    TEST_ASSERT_TRUE(static_cast<bool>(owned.back()));
+
+    others.clear();
+    owned.clear();
+    pool.unreserve(id);
+}
+
+void test_reservation_overflow()
+{
+    const PacketPool::ReservationId id = pool.reserve(2);
+    TEST_ASSERT_TRUE(id != 0);
+
+    // Сверх резерва владелец пользуется общей частью пула
+    std::vector<PacketRef> owned = exhaust(id);
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY, owned.size());
+    owned.clear();
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY - 2, pool.shared());
+
+    // Резерв не может превышать незарезервированную часть
+    TEST_ASSERT_EQUAL(0, pool.reserve(PacketPool::CAPACITY - 1));
+    pool.unreserve(id);
+}
+
+void test_unreserve_while_held()
+{
+    const PacketPool::ReservationId id = pool.reserve(3);
+    PacketRef packet = pool.acquire(id);
+    TEST_ASSERT_TRUE(static_cast<bool>(packet));
+
+    // Ячейка остаётся действительной и при освобождении уходит в общую часть
+    pool.unreserve(id);
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY - 1, pool.shared());
+    packet.reset();
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY, pool.shared());
+}
+
+void test_reservation_limit()
+{
+    std::vector<PacketPool::ReservationId> ids;
+    for (size_t i = 0; i < PacketPool::MAX_RESERVATIONS; i++)
+    {
+        ids.push_back(pool.reserve(1));
+        TEST_ASSERT_TRUE(ids.back() != 0);
+    }
+    TEST_ASSERT_EQUAL(0, pool.reserve(1));
+
+    for (const PacketPool::ReservationId id : ids) pool.unreserve(id);
+    pool.unreserve(0);
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_refcount);
+    RUN_TEST(test_copy_packet);
+    RUN_TEST(test_reservation);
+    RUN_TEST(test_reservation_overflow);
+    RUN_TEST(test_unreserve_while_held);
+    RUN_TEST(test_reservation_limit);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
@@ -0,0 +1,236 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка надёжной доставки: потеря, переупорядочивание, повторы и смена эпохи
+ * @details Запуск на компьютере: pio test -e native -f test_reliable.
+ *          Канал моделируется копированием кадров: тест решает, какие из них дойдут
+ */
+
+#include "net/reliable.h"
+
+#include <unity.h>
+
+#include <vector>
+
+using namespace net;
+
+namespace
+{
+    constexpr int64_t RTO = 250000; ///< ReliablePolicy::initialRtoUs
+
+    ReliableSession sender;
+    ReliableSession receiver;
+    std::vector<uint8_t> received;  ///< Первые байты выданных получателем данных
+    std::vector<uint8_t> delivered; ///< Первые байты кадров, подтверждённых отправителю
+    std::vector<uint8_t> lost;      ///< Первые байты кадров, от которых отправитель отказался
+
+    const ReliableSession::ResolveFunction resolve = [](PacketRef& frame, const bool ok)
+    {
+        (ok ? delivered : lost).push_back(frame->buffer[0]);
+    };
+
+    /**
+     * @brief Передать marker в окно отправки
+     * @return Packet Кадр, как он уходит в канал
+     */
+    Packet send(const uint8_t marker, const int64_t now)
+    {
+        PacketRef payload = PacketPool::instance().acquire();
+        payload->size = 4;
+        payload->buffer.fill(marker);
+
+        const PacketRef frame = sender.wrap(payload, now);
+        TEST_ASSERT_TRUE(static_cast<bool>(frame));
+        return *frame;
+    }
+
+    /**
+     * @brief Доставить кадр данных получателю
+     */
+    void receive(const Packet& frame)
+    {
+        TEST_ASSERT_TRUE(receiver.onData(frame, [](const Packet& payload) { received.push_back(payload.buffer[0]); }));
+    }
+
+    /**
+     * @brief Доставить отправителю текущее подтверждение получателя
+     */
+    size_t acknowledge(const int64_t now)
+    {
+        const PacketRef ack = receiver.takeAck();
+        TEST_ASSERT_TRUE(static_cast<bool>(ack));
+        return sender.onAck(*ack, now, resolve);
+    }
+
+    /**
+     * @brief Получить повторную передачу как кадр канала
+     */
+    Packet retransmit(const int64_t now)
+    {
+        const PacketRef frame = sender.retransmission(now);
+        TEST_ASSERT_TRUE(static_cast<bool>(frame));
+        return frame ? *frame : Packet{};
+    }
+} // namespace
+
+void setUp()
+{
+    sender.setPolicy(ReliablePolicy::windowed());
+    receiver.setPolicy(ReliablePolicy::windowed());
+    received.clear();
+    delivered.clear();
+    lost.clear();
+}
+
+void tearDown()
+{
+}
+
+void test_in_order()
+{
+    for (uint8_t i = 1; i <= 3; i++) receive(send(i, 0));
+    TEST_ASSERT_EQUAL(3, acknowledge(1000));
+
+    TEST_ASSERT_EQUAL(3, received.size());
+    TEST_ASSERT_EQUAL(3, delivered.size());
+    for (uint8_t i = 0; i < 3; i++) TEST_ASSERT_EQUAL(i + 1, received[i]);
+    TEST_ASSERT_EQUAL(1000, sender.smoothedRttUs());
+
+    // После подтверждения DATA_SYNC отправитель переходит на короткий заголовок
+    const Packet frame = send(4, 2000);
+    TEST_ASSERT_TRUE(ReliableSession::frameType(frame) == ReliableSession::FrameType::DATA);
+    receive(frame);
+    TEST_ASSERT_EQUAL(4, received.back());
+}
+
+void test_first_sync_lost()
+{
+    // Первый DATA_SYNC эпохи теряется: получатель не должен принять второй кадр за начало окна
+    (void)send(1, 0);
+    receive(send(2, 0));
+    TEST_ASSERT_EQUAL(0, received.size());
+    TEST_ASSERT_EQUAL(0, acknowledge(1000));
+
+    receive(retransmit(RTO));
+    TEST_ASSERT_EQUAL(2, received.size());
+    TEST_ASSERT_EQUAL(1, received[0]);
+    TEST_ASSERT_EQUAL(2, received[1]);
+
+    TEST_ASSERT_EQUAL(2, acknowledge(RTO + 1000));
+    TEST_ASSERT_EQUAL(0, lost.size());
+    TEST_ASSERT_EQUAL(-1, sender.timeoutUs(RTO + 1000));
+}
+
+void test_reorder_and_duplicates()
+{
+    std::vector<Packet> frames;
+    for (uint8_t i = 1; i <= 4; i++) frames.push_back(send(i, 0));
+
+    receive(frames[0]);
+    receive(frames[2]);
+    receive(frames[3]);
+    receive(frames[2]);
+    TEST_ASSERT_EQUAL(1, received.size());
+
+    // Выборочно подтверждённые кадры не передаются повторно
+    TEST_ASSERT_EQUAL(1, acknowledge(1000));
+    const Packet again = retransmit(RTO);
+    TEST_ASSERT_EQUAL(frames[1].buffer[1], again.buffer[1]);
+    TEST_ASSERT_FALSE(static_cast<bool>(sender.retransmission(RTO)));
+
+    receive(again);
+    receive(frames[0]);
+    TEST_ASSERT_EQUAL(4, received.size());
+    for (uint8_t i = 0; i < 4; i++) TEST_ASSERT_EQUAL(i + 1, received[i]);
+
+    TEST_ASSERT_EQUAL(3, acknowledge(RTO + 1000));
+    TEST_ASSERT_EQUAL(4, delivered.size());
+}
+
+void test_abandon_resyncs_window()
+{
+    ReliablePolicy policy = ReliablePolicy::windowed();
+    policy.maxRetransmits = 1;
+    sender.setPolicy(policy);
+
+    // Первый кадр не доходит ни разу, второй и третий приняты, но подтверждения потеряны
+    (void)send(1, 0);
+    receive(send(2, 0));
+    receive(send(3, 0));
+    (void)receiver.takeAck();
+
+    (void)retransmit(RTO);
+    TEST_ASSERT_EQUAL(0, sender.abandon(RTO, resolve));
+    TEST_ASSERT_EQUAL(1, sender.abandon(3 * RTO, resolve));
+    TEST_ASSERT_EQUAL(1, lost.size());
+    TEST_ASSERT_EQUAL(1, lost[0]);
+
+    // Оставшиеся кадры переходят в новую эпоху, первый из них передаётся сразу
+    const Packet next = retransmit(3 * RTO);
+    TEST_ASSERT_TRUE(ReliableSession::frameType(next) == ReliableSession::FrameType::DATA_SYNC);
+    TEST_ASSERT_EQUAL(2, next.buffer[ReliableSession::MAX_OVERHEAD]);
+    TEST_ASSERT_EQUAL(0, received.size());
+
+    receive(next);
+    TEST_ASSERT_EQUAL(2, received.size());
+    TEST_ASSERT_EQUAL(2, received[0]);
+    TEST_ASSERT_EQUAL(3, received[1]);
+
+    TEST_ASSERT_EQUAL(2, acknowledge(3 * RTO + 1000));
+    TEST_ASSERT_EQUAL(2, delivered.size());
+    TEST_ASSERT_EQUAL(-1, sender.timeoutUs(3 * RTO + 1000));
+}
+
+void test_abandon_after_lost_ack()
+{
+    ReliablePolicy policy = ReliablePolicy::windowed();
+    policy.maxRetransmits = 0;
+    sender.setPolicy(policy);
+
+    // Кадр выдан, но подтверждение потеряно: новая эпоха не должна выдать его повторно
+    receive(send(1, 0));
+    (void)receiver.takeAck();
+    TEST_ASSERT_EQUAL(1, sender.abandon(RTO, resolve));
+
+    receive(send(2, RTO));
+    TEST_ASSERT_EQUAL(2, received.size());
+    TEST_ASSERT_EQUAL(1, received[0]);
+    TEST_ASSERT_EQUAL(2, received[1]);
+    TEST_ASSERT_EQUAL(1, acknowledge(RTO + 1000));
+}
+
+void test_stale_ack_ignored()
+{
+    receive(send(1, 0));
+    const PacketRef ack = receiver.takeAck();
+    TEST_ASSERT_TRUE(static_cast<bool>(ack));
+
+    // Подтверждение прошлой сессии не освобождает кадры новой
+    sender.reset();
+    (void)send(2, 0);
+    TEST_ASSERT_EQUAL(0, sender.onAck(*ack, 1000, resolve));
+    TEST_ASSERT_EQUAL(0, delivered.size());
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_in_order);
+    RUN_TEST(test_first_sync_lost);
+    RUN_TEST(test_reorder_and_duplicates);
+    RUN_TEST(test_abandon_resyncs_window);
+    RUN_TEST(test_abandon_after_lost_ack);
+    RUN_TEST(test_stale_ack_ignored);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка политики повторной отправки: экспоненциальная пауза, предел и разброс
+ * @details Запуск на компьютере: pio test -e native -f test_retry
+ */
+
+#include "net/retry.h"
+
+#include <unity.h>
+
+#include <algorithm>
+
+using namespace net;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_exponential()
+{
+    RetryPolicy policy = RetryPolicy::exponential(8, 1000, 20000);
+    policy.jitterPercent = 0;
+
+    TEST_ASSERT_EQUAL(1000, policy.delayUs(1));
+    TEST_ASSERT_EQUAL(2000, policy.delayUs(2));
+    TEST_ASSERT_EQUAL(4000, policy.delayUs(3));
+    TEST_ASSERT_EQUAL(16000, policy.delayUs(5));
+    TEST_ASSERT_EQUAL(20000, policy.delayUs(6));
+
+    // Счётчик 0 трактуется как первая попытка
+    TEST_ASSERT_EQUAL(1000, policy.delayUs(0));
+}
+
+void test_no_overflow()
+{
+    RetryPolicy policy = RetryPolicy::exponential(RetryPolicy::MAX_ATTEMPTS, 0xFFFFFFFF, 0xFFFFFFFF);
+    policy.jitterPercent = 0;
+
+    // Большой счётчик попыток не переполняет сдвиг
+    for (uint8_t attempts = 1; attempts <= RetryPolicy::MAX_ATTEMPTS; attempts++)
+    {
+        TEST_ASSERT_EQUAL_INT64(0xFFFFFFFF, policy.delayUs(attempts));
+    }
+    TEST_ASSERT_EQUAL_INT64(0xFFFFFFFF, policy.delayUs(255));
+}
+
+void test_jitter()
+{
+    const RetryPolicy policy = RetryPolicy::exponential(8, 40000, 1000000);
+
+    // Пауза уменьшается случайно не более чем на jitterPercent процентов
+    int64_t low = policy.delayUs(2);
+    int64_t high = low;
+    for (int i = 0; i < 1000; i++)
+    {
+        const int64_t delay = policy.delayUs(2);
+        low = std::min(low, delay);
+        high = std::max(high, delay);
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(60000, low);
+    TEST_ASSERT_LESS_OR_EQUAL(80000, high);
+    TEST_ASSERT_TRUE(high - low > 10000);
+
+    // Разброс больше 100 % ограничивается паузой целиком
+    RetryPolicy wide = policy;
+    wide.jitterPercent = 250;
+    for (int i = 0; i < 1000; i++)
+    {
+        const int64_t delay = wide.delayUs(1);
+        TEST_ASSERT_TRUE(delay >= 0 && delay <= 40000);
+    }
+}
+
+void test_attempts()
+{
+    const RetryPolicy none = RetryPolicy::none();
+    TEST_ASSERT_FALSE(none.canRetry(1));
+
+    const RetryPolicy policy = RetryPolicy::exponential(3, 1000, 20000, RetryPolicy::Mode::REQUEUE);
+    TEST_ASSERT_TRUE(policy.mode == RetryPolicy::Mode::REQUEUE);
+    TEST_ASSERT_TRUE(policy.canRetry(1));
+    TEST_ASSERT_TRUE(policy.canRetry(2));
+    TEST_ASSERT_FALSE(policy.canRetry(3));
+
+    // Счётчик в ячейке пула ограничен MAX_ATTEMPTS
+    const RetryPolicy endless = RetryPolicy::exponential(255, 1000, 20000);
+    TEST_ASSERT_TRUE(endless.canRetry(RetryPolicy::MAX_ATTEMPTS - 1));
+    TEST_ASSERT_FALSE(endless.canRetry(RetryPolicy::MAX_ATTEMPTS));
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_exponential);
+    RUN_TEST(test_no_overflow);
+    RUN_TEST(test_jitter);
+    RUN_TEST(test_attempts);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
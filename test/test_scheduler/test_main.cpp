@@ -0,0 +1,123 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка планировщика классов приоритета: строгий и взвешенный режимы
+ * @details Запуск на компьютере: pio test -e native -f test_scheduler
+ */
+
+#include "net/scheduler.h"
+
+#include <unity.h>
+
+#include <array>
+
+using namespace net;
+
+namespace
+{
+    constexpr std::array<bool, PRIORITY_COUNT> ALL = {true, true, true};
+
+    PriorityScheduler scheduler;
+
+    /**
+     * @brief Количество выборов каждого класса за count вызовов
+     */
+    std::array<size_t, PRIORITY_COUNT> pick(const size_t count, const std::array<bool, PRIORITY_COUNT>& pending)
+    {
+        std::array<size_t, PRIORITY_COUNT> picks{};
+        for (size_t i = 0; i < count; i++)
+        {
+            const std::optional<Priority> next = scheduler.next(pending);
+            TEST_ASSERT_TRUE(next.has_value());
+            picks[static_cast<size_t>(*next)]++;
+        }
+        return picks;
+    }
+} // namespace
+
+void setUp()
+{
+    scheduler.setPolicy(SchedulingPolicy::strict());
+}
+
+void tearDown()
+{
+}
+
+void test_strict()
+{
+    TEST_ASSERT_TRUE(scheduler.next(ALL) == Priority::CONTROL);
+    TEST_ASSERT_TRUE(scheduler.next({false, true, true}) == Priority::INTERACTIVE);
+    TEST_ASSERT_TRUE(scheduler.next({false, false, true}) == Priority::BULK);
+    TEST_ASSERT_FALSE(scheduler.next({false, false, false}).has_value());
+}
+
+void test_weighted_shares()
+{
+    scheduler.setPolicy(SchedulingPolicy::weighted(8, 4, 1));
+
+    // За каждый раунд из 13 отправок классы получают доли по весам
+    const std::array<size_t, PRIORITY_COUNT> picks = pick(13 * 10, ALL);
+    TEST_ASSERT_EQUAL(80, picks[0]);
+    TEST_ASSERT_EQUAL(40, picks[1]);
+    TEST_ASSERT_EQUAL(10, picks[2]);
+}
+
+void test_weighted_idle_class()
+{
+    scheduler.setPolicy(SchedulingPolicy::weighted(8, 4, 1));
+
+    // Кредиты пустого класса не задерживают остальные
+    const std::array<size_t, PRIORITY_COUNT> picks = pick(5 * 10, {false, true, true});
+    TEST_ASSERT_EQUAL(0, picks[0]);
+    TEST_ASSERT_EQUAL(40, picks[1]);
+    TEST_ASSERT_EQUAL(10, picks[2]);
+
+    TEST_ASSERT_TRUE(scheduler.next({false, false, true}) == Priority::BULK);
+    TEST_ASSERT_FALSE(scheduler.next({false, false, false}).has_value());
+}
+
+void test_weighted_zero_weight()
+{
+    // Нулевой вес трактуется как единичный: класс не голодает
+    scheduler.setPolicy(SchedulingPolicy::weighted(3, 0, 0));
+
+    const std::array<size_t, PRIORITY_COUNT> picks = pick(5 * 4, ALL);
+    TEST_ASSERT_EQUAL(12, picks[0]);
+    TEST_ASSERT_EQUAL(4, picks[1]);
+    TEST_ASSERT_EQUAL(4, picks[2]);
+}
+
+void test_policy_resets_credits()
+{
+    scheduler.setPolicy(SchedulingPolicy::weighted(1, 1, 1));
+    TEST_ASSERT_TRUE(scheduler.next(ALL) == Priority::CONTROL);
+
+    // Новая политика начинает раунд заново
+    scheduler.setPolicy(SchedulingPolicy::weighted(1, 1, 1));
+    TEST_ASSERT_TRUE(scheduler.next(ALL) == Priority::CONTROL);
+    TEST_ASSERT_TRUE(scheduler.next(ALL) == Priority::INTERACTIVE);
+    TEST_ASSERT_TRUE(scheduler.policy().mode == SchedulingPolicy::Mode::WEIGHTED);
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_strict);
+    RUN_TEST(test_weighted_shares);
+    RUN_TEST(test_weighted_idle_class);
+    RUN_TEST(test_weighted_zero_weight);
+    RUN_TEST(test_policy_resets_credits);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка очереди дескрипторов пакетов, через которую BLE передаёт принятые пакеты рабочему потоку
+ * @details Запуск на компьютере: pio test -e native -f test_send_queue
+ */
+
+#include "net/send_queue.h"
+
+#include <unity.h>
+
+using namespace net;
+
+namespace
+{
+    PacketPool& pool = PacketPool::instance();
+
+    /**
+     * @brief Пакет пула с идентификатором id
+     */
+    PacketRef make(const uint16_t id)
+    {
+        PacketRef packet = pool.acquire();
+        TEST_ASSERT_TRUE(static_cast<bool>(packet));
+        packet->id = id;
+        packet->size = 1;
+        return packet;
+    }
+} // namespace
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY, pool.available());
+}
+
+void test_fifo()
+{
+    HandleQueue queue(4);
+    for (uint16_t id = 1; id <= 3; id++)
+    {
+        PacketRef packet = make(id);
+        TEST_ASSERT_TRUE(queue.push(packet));
+        TEST_ASSERT_FALSE(static_cast<bool>(packet));
+    }
+    TEST_ASSERT_EQUAL(3, queue.size());
+
+    // Пакет остаётся в ячейке пула, пока ожидает в очереди
+    TEST_ASSERT_EQUAL(PacketPool::CAPACITY - 3, pool.available());
+    for (uint16_t id = 1; id <= 3; id++)
+    {
+        const PacketRef packet = queue.pop();
+        TEST_ASSERT_TRUE(static_cast<bool>(packet));
+        TEST_ASSERT_EQUAL(id, packet->id);
+    }
+    TEST_ASSERT_FALSE(static_cast<bool>(queue.pop()));
+}
+
+void test_full()
+{
+    HandleQueue queue(2);
+    PacketRef first = make(1);
+    PacketRef second = make(2);
+    TEST_ASSERT_TRUE(queue.push(first));
+    TEST_ASSERT_TRUE(queue.push(second));
+
+    // Заполненная очередь возвращает владение пакетом вызывающему
+    PacketRef extra = make(3);
+    TEST_ASSERT_FALSE(queue.push(extra));
+    TEST_ASSERT_TRUE(static_cast<bool>(extra));
+    TEST_ASSERT_EQUAL(3, extra->id);
+
+    TEST_ASSERT_EQUAL(1, queue.pop()->id);
+    TEST_ASSERT_TRUE(queue.push(extra));
+    TEST_ASSERT_EQUAL(2, queue.pop()->id);
+    TEST_ASSERT_EQUAL(3, queue.pop()->id);
+}
+
+void test_depth_clamped()
+{
+    HandleQueue empty(0);
+    PacketRef packet = make(1);
+    TEST_ASSERT_TRUE(empty.push(packet));
+    PacketRef extra = make(2);
+    TEST_ASSERT_FALSE(empty.push(extra));
+    extra.reset();
+    empty.clear();
+
+    // Глубина больше MAX_SIZE ограничивается MAX_SIZE (пул вмещает ровно столько пакетов)
+    static_assert(HandleQueue::MAX_SIZE <= PacketPool::CAPACITY);
+    HandleQueue deep(HandleQueue::MAX_SIZE * 2);
+    for (size_t i = 0; i < HandleQueue::MAX_SIZE; i++)
+    {
+        PacketRef next = make(static_cast<uint16_t>(i));
+        TEST_ASSERT_TRUE(deep.push(next));
+    }
+    TEST_ASSERT_EQUAL(HandleQueue::MAX_SIZE, deep.size());
+}
+
+void test_clear_releases()
+{
+    {
+        HandleQueue queue(8);
+        for (uint16_t id = 1; id <= 5; id++)
+        {
+            PacketRef packet = make(id);
+            TEST_ASSERT_TRUE(queue.push(packet));
+        }
+        TEST_ASSERT_EQUAL(5, queue.clear());
+        TEST_ASSERT_EQUAL(0, queue.size());
+        TEST_ASSERT_EQUAL(PacketPool::CAPACITY, pool.available());
+
+        PacketRef packet = make(6);
+        TEST_ASSERT_TRUE(queue.push(packet));
+    }
+    // Деструктор возвращает оставшиеся пакеты в пул (проверяется в tearDown)
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo);
+    RUN_TEST(test_full);
+    RUN_TEST(test_depth_clamped);
+    RUN_TEST(test_clear_releases);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
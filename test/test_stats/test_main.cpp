@@ -0,0 +1,124 @@
+/**
+ * @file test_main.cpp
+ * @brief Проверка статистики транспорта: счётчики, причины потерь и гистограмма задержки
+ * @details Запуск на компьютере: pio test -e native -f test_stats
+ */
+
+#include "net/stats.h"
+
+#include <unity.h>
+
+using namespace net;
+
+namespace
+{
+    constexpr uint32_t BASE = TransportStats::LATENCY_BASE_US;
+
+    StatsCollector collector;
+} // namespace
+
+void setUp()
+{
+    collector.reset();
+}
+
+void tearDown()
+{
+}
+
+void test_latency_buckets()
+{
+    TEST_ASSERT_EQUAL(0, StatsCollector::latencyBucket(0));
+    TEST_ASSERT_EQUAL(0, StatsCollector::latencyBucket(BASE - 1));
+    TEST_ASSERT_EQUAL(1, StatsCollector::latencyBucket(BASE));
+    TEST_ASSERT_EQUAL(1, StatsCollector::latencyBucket(2 * BASE - 1));
+    TEST_ASSERT_EQUAL(2, StatsCollector::latencyBucket(2 * BASE));
+    TEST_ASSERT_EQUAL(10, StatsCollector::latencyBucket(BASE << 9));
+
+    // Последний интервал не ограничен сверху
+    const size_t last = TransportStats::LATENCY_BUCKETS - 1;
+    TEST_ASSERT_EQUAL(last, StatsCollector::latencyBucket(BASE << (last - 1)));
+    TEST_ASSERT_EQUAL(last, StatsCollector::latencyBucket(BASE << last));
+    TEST_ASSERT_EQUAL(last, StatsCollector::latencyBucket(UINT32_MAX));
+}
+
+void test_counters()
+{
+    collector.onSent(100, 10);
+    collector.onSent(50, 3 * BASE);
+    collector.onReceived(20);
+    collector.onRetry();
+    collector.onSendError(ESP_ERR_TIMEOUT);
+    collector.onSendError(ESP_ERR_NO_MEM);
+
+    const TransportStats stats = collector.snapshot();
+    TEST_ASSERT_EQUAL(2, stats.packetsSent);
+    TEST_ASSERT_EQUAL(150, stats.bytesSent);
+    TEST_ASSERT_EQUAL(1, stats.packetsReceived);
+    TEST_ASSERT_EQUAL(20, stats.bytesReceived);
+    TEST_ASSERT_EQUAL(1, stats.retries);
+    TEST_ASSERT_EQUAL(2, stats.sendErrors);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, stats.lastError);
+    TEST_ASSERT_EQUAL(1, stats.latency[0]);
+    TEST_ASSERT_EQUAL(1, stats.latency[2]);
+}
+
+void test_drops()
+{
+    collector.onDrop(DropReason::EXPIRED);
+    collector.onDrop(DropReason::EXPIRED);
+    collector.onDrop(DropReason::PEER_OVERFLOW);
+
+    const TransportStats stats = collector.snapshot();
+    TEST_ASSERT_EQUAL(2, stats.dropped(DropReason::EXPIRED));
+    TEST_ASSERT_EQUAL(1, stats.dropped(DropReason::PEER_OVERFLOW));
+    TEST_ASSERT_EQUAL(0, stats.dropped(DropReason::REJECTED));
+    TEST_ASSERT_EQUAL(static_cast<size_t>(DropReason::PEER_OVERFLOW) + 1, DROP_REASON_COUNT);
+}
+
+void test_queue_high_water()
+{
+    collector.onQueueDepth(3);
+    collector.onQueueDepth(12);
+    collector.onQueueDepth(5);
+    TEST_ASSERT_EQUAL(12, collector.snapshot().queueHighWater);
+}
+
+void test_reset()
+{
+    collector.onSent(100, 10);
+    collector.onDrop(DropReason::MALFORMED);
+    collector.onSendError(ESP_FAIL);
+    collector.onQueueDepth(7);
+    collector.reset();
+
+    const TransportStats stats = collector.snapshot();
+    TEST_ASSERT_EQUAL(0, stats.packetsSent);
+    TEST_ASSERT_EQUAL(0, stats.dropped(DropReason::MALFORMED));
+    TEST_ASSERT_EQUAL(ESP_OK, stats.lastError);
+    TEST_ASSERT_EQUAL(0, stats.queueHighWater);
+    TEST_ASSERT_EQUAL(0, stats.latency[0]);
+}
+
+int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_latency_buckets);
+    RUN_TEST(test_counters);
+    RUN_TEST(test_drops);
+    RUN_TEST(test_queue_high_water);
+    RUN_TEST(test_reset);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+extern "C" void app_main()
+{
+    runTests();
+}
+#else
+int main()
+{
+    return runTests();
+}
+#endif
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""Преобразование журнала Transport::dumpTrace() в формат Chrome trace.
+
+Скрипт читает лог устройства (монитор порта, файл), выбирает строки вида
+``I (1234) BLE: trace <time> <event> id=<id> size=<size> prio=<prio> tag=<tag> status=<status>``
+и формирует JSON, который открывается в chrome://tracing или https://ui.perfetto.dev.
+
+Интервалы:
+  queue    - от постановки в очередь до извлечения (включает ожидание ограничителя скорости)
+  send     - вызов sendImpl()
+  callback - обработка принятого пакета в callback данных
+
+Пример:
+  python3 tools/trace_to_chrome.py monitor.log -o trace.json
+"""
+
+import argparse
+import json
+import re
+import sys
+
+LINE_RE = re.compile(
+    r"(?P<transport>[\w-]+): trace (?P<time>\d+) (?P<event>\w+) id=(?P<id>\d+) size=(?P<size>\d+)"
+    r" prio=(?P<prio>\d+) tag=(?P<tag>\d+) status=(?P<status>-?\d+)"
+)
+ANSI_RE = re.compile(r"\x1b\[[0-9;]*m")
+
+PRIORITIES = {0: "CONTROL", 1: "INTERACTIVE", 2: "BULK"}
+WRAP = 1 << 32
+
+
+def parse(lines):
+    """Выбирает записи журнала и восстанавливает 64-битное время после переполнения 32 бит."""
+    last = {}
+    offset = {}
+    for line in lines:
+        match = LINE_RE.search(ANSI_RE.sub("", line))
+        if not match:
+            continue
+
+        record = match.groupdict()
+        transport = record["transport"]
+        time = int(record["time"])
+        if transport in last and time + offset[transport] < last[transport] - WRAP // 2:
+            offset[transport] += WRAP
+        offset.setdefault(transport, 0)
+        time += offset[transport]
+        last[transport] = time
+
+        yield {
+            "transport": transport,
+            "time": time,
+            "event": record["event"],
+            "id": int(record["id"]),
+            "size": int(record["size"]),
+            "prio": int(record["prio"]),
+            "tag": int(record["tag"]),
+            "status": int(record["status"]),
+        }
+
+
+def convert(records):
+    """Строит события Chrome trace из записей журнала."""
+    events = []
+    pids = {}
+    queued = {}
+    sending = {}
+    callbacks = {}
+
+    for record in records:
+        transport = record["transport"]
+        if transport not in pids:
+            pids[transport] = len(pids) + 1
+            events.append({"name": "process_name", "ph": "M", "pid": pids[transport],
+                           "args": {"name": transport}})
+            for tid, name in ((1, "queue"), (2, "send"), (3, "rx")):
+                events.append({"name": "thread_name", "ph": "M", "pid": pids[transport], "tid": tid,
+                               "args": {"name": name}})
+
+        pid = pids[transport]
+        key = (transport, record["id"], record["tag"])
+        args = {"id": record["id"], "size": record["size"],
+                "priority": PRIORITIES.get(record["prio"], record["prio"])}
+        event = record["event"]
+        time = record["time"]
+
+        if event == "enqueue":
+            queued[key] = time
+            events.append({"name": "queue", "cat": "tx", "ph": "b", "id": "%s:%d:%d" % key,
+                           "pid": pid, "tid": 1, "ts": time, "args": args})
+        elif event == "dequeue":
+            if queued.pop(key, None) is not None:
+                events.append({"name": "queue", "cat": "tx", "ph": "e", "id": "%s:%d:%d" % key,
+                               "pid": pid, "tid": 1, "ts": time})
+        elif event == "send_start":
+            sending[transport] = time
+        elif event == "send_done":
+            start = sending.pop(transport, time)
+            args["status"] = record["status"]
+            events.append({"name": "send", "cat": "tx", "ph": "X", "pid": pid, "tid": 2,
+                           "ts": start, "dur": time - start, "args": args})
+        elif event == "rx":
+            # Метка возвратов из callback - время события RX
+            callbacks[(transport, time & (WRAP - 1))] = time
+            events.append({"name": "rx", "cat": "rx", "ph": "i", "s": "t", "pid": pid, "tid": 3,
+                           "ts": time, "args": args})
+        elif event == "callback_done":
+            # Несколько пакетов одного объединённого пакета обрабатываются подряд
+            rx_key = (transport, record["tag"])
+            start = callbacks.get(rx_key, time)
+            callbacks[rx_key] = time
+            events.append({"name": "callback", "cat": "rx", "ph": "X", "pid": pid, "tid": 3,
+                           "ts": start, "dur": time - start, "args": args})
+
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Transport trace log to Chrome trace JSON")
+    parser.add_argument("input", nargs="?", help="лог устройства (по умолчанию stdin)")
+    parser.add_argument("-o", "--output", help="файл JSON (по умолчанию stdout)")
+    args = parser.parse_args()
+
+    source = open(args.input, encoding="utf-8", errors="replace") if args.input else sys.stdin
+    with source:
+        trace = convert(parse(source))
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as out:
+            json.dump(trace, out)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()